@@ -0,0 +1,622 @@
+#!/usr/bin/env python3
+"""Generate a patch-specialized Four/Vortex renderer.
+
+Run from project root:
+    python3 scripts/generate_kernel.py renders/00_FourMM_11.params --run
+
+Input is a params file as written by scripts/render_patch.py (model slug,
+then "<param id> <value>" lines). The output is a C++ translation unit in
+which everything that shapes the per-sample code is a compile-time constant:
+
+    Four    algorithm (routes unrolled, silent operators dropped), operator
+            levels, warps, folds, fold types, feedback, frequency modes,
+            oversampling and alias guard
+    Vortex  mode (filter order, response type, cascade and morph resolved
+            in the emitted code), drive, envelope follower on/off and update
+            rate, fixed internal rate
+
+Settings that only feed setup (operator frequencies, filter coefficients)
+are still computed by the engine at startup. Vortex keeps the filter state
+and coefficients its mode uses in locals for the whole render. Fields moved by Four's
+built-in modulation stay runtime values.
+
+The program renders the patch through the generic engine (tools/render.h)
+and through the specialized kernel, checks that the outputs match, and
+reports both throughputs. With --run it is compiled and run right away.
+
+Outputs:
+    <params>.kernel.cpp  - specialized renderer (or -o)
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Largest difference from the generic engine accepted by the generated check
+TOLERANCE = '1e-4f'
+
+
+def read_enum(path, name):
+    """Values of a C++ enum from a header (explicit or sequential)."""
+    with open(path) as f:
+        text = f.read()
+    body = re.search(r'enum\s+%s\s*\{(.*?)\};' % name, text, re.S).group(1)
+    values = {}
+    value = -1
+    for line in body.splitlines():
+        line = line.split('//')[0].strip().rstrip(',')
+        if not line:
+            continue
+        match = re.match(r'(\w+)\s*(?:=\s*(\d+))?$', line)
+        value = int(match.group(2)) if match.group(2) else value + 1
+        values[match.group(1)] = value
+    return values
+
+
+def read_algorithms(path):
+    """four::algorithms from dsp.h as (mod[src][dst], carrier[op]) pairs."""
+    with open(path) as f:
+        text = f.read()
+    body = re.search(r'Algorithm algorithms\[11\] = \{(.*?)\n\};', text, re.S).group(1)
+    rows = [[int(x) for x in row.split(',')] for row in re.findall(r'\{([01],[01],[01],[01])\}', body)]
+    carriers = [[x.strip() == 'true' for x in row.split(',')]
+                for row in re.findall(r'\{((?:true|false)(?:,\s*(?:true|false)){3})\}', body)]
+    return [(rows[a * 4:a * 4 + 4], carriers[a]) for a in range(len(carriers))]
+
+
+def read_params(path):
+    with open(path) as f:
+        tokens = f.read().split()
+    saved = {}
+    for i in range(1, len(tokens) - 1, 2):
+        saved[int(tokens[i])] = float(tokens[i + 1])
+    return tokens[0], saved
+
+
+def cfloat(value):
+    """C++ float literal for a value read from a params file."""
+    text = '%.9g' % value
+    if not re.search(r'[.eEn]', text):
+        text += '.0'
+    return text + 'f'
+
+
+def carray(values):
+    return '{ ' + ', '.join(values) + ' }'
+
+
+def emit_header(lines, source, model, saved):
+    lines += [
+        '// Generated by scripts/generate_kernel.py from %s -- do not edit.' % os.path.basename(source),
+        '// %s renderer specialized for one set of panel values.' % model,
+        '',
+        '#include "render.h"',
+        '#include "wav.h"',
+        '',
+        '#include <stdlib.h>',
+        '',
+        'static const int SAVED_COUNT = %d;' % len(saved),
+        'static const PanelValue SAVED[] = {',
+    ]
+    lines += ['    { %d, %s },' % (pid, cfloat(v)) for pid, v in sorted(saved.items())]
+    if not saved:
+        lines.append('    { -1, 0.f },')
+    lines += ['};', '']
+
+
+def emit_four(lines, ids, saved, algorithms):
+    def value(pid, default):
+        return saved.get(pid, default)
+
+    algorithm = max(0, min(10, int(value(ids['PANEL_ALGO'], 0.0))))
+    mod_master = value(ids['PANEL_XM'], 1.0)
+    vca = value(ids['PANEL_VCA'], 1.0)
+
+    def per_op(base, defaults):
+        return [value(ids[base] + op, defaults[op]) for op in range(4)]
+
+    level = per_op('PANEL_OP_LEVEL', [1.0, 0.0, 0.0, 0.0])
+    warp = per_op('PANEL_OP_WARP', [0.0] * 4)
+    fold = per_op('PANEL_OP_FOLD', [0.0] * 4)
+    feedback = per_op('PANEL_OP_FB', [0.0] * 4)
+    freq_mode = [int(v) for v in per_op('PANEL_OP_FREQ_MODE', [0.0] * 4)]
+    fold_type = [int(v) for v in per_op('PANEL_OP_FOLD_TYPE', [0.0] * 4)]
+
+    # Anti-aliasing mode, see four::engine_set_antialias
+    antialias = int(value(ids['PANEL_ANTIALIAS'], 0.0))
+    oversample = 1 if antialias == 2 else 2
+    alias_guard = antialias in (1, 2)
+
+    # Built-in modulation: which (target, op) fields move at runtime
+    targets = ['opLevel', 'opWarp', 'opFold', 'opFeedback']
+    modulated = [[any(value(ids['PANEL_OP_MOD_AMOUNT'] + (src * 4 + t) * 4 + op, 0.0) != 0.0
+                      for src in range(2)) for op in range(4)] for t in range(4)]
+    any_modulated = any(any(row) for row in modulated)
+    needs_params = any_modulated or alias_guard
+
+    def field(t, op, name):
+        return 'm.%s[%d]' % (targets[t], op) if modulated[t][op] else '%s[%d]' % (name, op)
+
+    routes, carrier = algorithms[algorithm]
+
+    # Operators whose output can reach the mix, from the carriers up
+    def audible(op):
+        return level[op] != 0.0 or modulated[0][op]
+
+    live = [False] * 4
+    for op in range(4):
+        if carrier[op] and audible(op):
+            live[op] = True
+        elif audible(op) and mod_master != 0.0:
+            live[op] = any(routes[op][dst] and live[dst] for dst in range(op))
+
+    lines += [
+        '// Algorithm %d; operators %s are silent and not computed' % (
+            algorithm + 1, ', '.join(str(op + 1) for op in range(4) if not live[op]) or 'none'),
+        'static const int ALGORITHM = %d;' % algorithm,
+        'static const float MOD_MASTER = %s;' % cfloat(mod_master),
+        'static const float GLOBAL_VCA = %s;' % cfloat(vca),
+        'static const int OVERSAMPLE = %d;' % oversample,
+        'static const bool ALIAS_GUARD = %s;' % ('true' if alias_guard else 'false'),
+        'static const int FREQ_MODE[4] = %s;' % carray(str(v) for v in freq_mode),
+        'static const int FOLD_TYPE[4] = %s;' % carray(str(v) for v in fold_type),
+        'static const float LEVEL[4] = %s;' % carray(cfloat(v) for v in level),
+        'static const float WARP[4] = %s;' % carray(cfloat(v) for v in warp),
+        'static const float FOLD[4] = %s;' % carray(cfloat(v) for v in fold),
+        'static const float FEEDBACK[4] = %s;' % carray(cfloat(v) for v in feedback),
+        'static const bool ROUTE[4][4] = %s;' % carray(
+            carray('true' if r else 'false' for r in row) for row in routes),
+        'static const bool CARRIER[4] = %s;' % carray('true' if c else 'false' for c in carrier),
+        '',
+        '// Constants still match the engine and its routing table (see dsp.h)',
+        'static bool kernel_matches( const four::EngineParams& p )',
+        '{',
+        '    bool match = p.algorithm == ALGORITHM && p.modMaster == MOD_MASTER && p.globalVCA == GLOBAL_VCA',
+        '              && p.oversample == OVERSAMPLE && p.aliasGuard == ALIAS_GUARD;',
+        '    for ( int op = 0; op < 4; op++ )',
+        '    {',
+        '        match = match && p.opFreqMode[op] == FREQ_MODE[op] && p.opFoldType[op] == FOLD_TYPE[op]',
+        '              && p.opLevel[op] == LEVEL[op] && p.opWarp[op] == WARP[op] && p.opFold[op] == FOLD[op]',
+        '              && p.opFeedback[op] == FEEDBACK[op] && four::algorithms[ALGORITHM].carrier[op] == CARRIER[op];',
+        '        for ( int dst = 0; dst < 4; dst++ )',
+        '            match = match && four::algorithms[ALGORITHM].mod[op][dst] == ROUTE[op][dst];',
+        '    }',
+        '    return match;',
+        '}',
+        '',
+        '// One sample, OVERSAMPLE passes (same arithmetic as engine_process_freq)',
+        'static inline float kernel_process( four::EngineState& state, const float freq[4], float osTime%s )' % (
+            ', const four::EngineParams& m' if needs_params else ''),
+        '{',
+        '    float result[OVERSAMPLE];',
+    ]
+    if alias_guard:
+        lines.append('    four::engine_alias_guard_tick( state.guard, m, freq, osTime * OVERSAMPLE );')
+    lines += [
+        '    for ( int pass = 0; pass < OVERSAMPLE; pass++ )',
+        '    {',
+    ]
+
+    for op in range(3, -1, -1):
+        if not live[op]:
+            continue
+        n = op + 1
+        terms = ['out%d * %s * MOD_MASTER' % (src + 1, field(0, src, 'LEVEL'))
+                 for src in range(op + 1, 4) if routes[src][op] and live[src]]
+        if terms and alias_guard:
+            terms = ['( %s ) * state.guard.scale[%d]' % (' + '.join(terms), op)]
+        has_feedback = feedback[op] != 0.0 or modulated[3][op]
+        if has_feedback:
+            terms.append('four::calc_feedback( state.ops[%d].prevOutput, %s )' % (op, field(3, op, 'FEEDBACK')))
+        lines += [
+            '        // Operator %d' % n,
+            '        float inc%d = freq[%d] * osTime;' % (n, op),
+            '        four::phase_advance( state.ops[%d].phase, inc%d );' % (op, n),
+        ]
+        if terms:
+            lines += [
+                '        float phase%d = state.ops[%d].phase + ( %s );' % (n, op, ' + '.join(terms)),
+                '        phase%d -= floorf( phase%d );' % (n, n),
+                '        if ( phase%d < 0.f ) phase%d += 1.f;' % (n, n),
+            ]
+        else:
+            lines.append('        float phase%d = state.ops[%d].phase;' % (n, op))
+        lines.append('        float out%d = four::wave_warp_blep( phase%d, %s, inc%d );' % (n, n, field(1, op, 'WARP'), n))
+        if fold[op] > 0.0 or modulated[2][op]:
+            lines.append('        out%d = four::wave_fold( out%d, %s, FOLD_TYPE[%d] );' % (n, n, field(2, op, 'FOLD'), op))
+        if has_feedback:
+            lines.append('        state.ops[%d].prevOutput = out%d;' % (op, n))
+        lines.append('')
+
+    mix = ['out%d * %s' % (op + 1, field(0, op, 'LEVEL')) for op in range(4) if carrier[op] and live[op]]
+    lines += [
+        '        result[pass] = %s;' % (' + '.join(mix) if mix else '0.f'),
+        '    }',
+        '',
+        '    float out = %s;' % ('four::downsample_2x( result[0], result[1] )' if oversample == 2 else 'result[0]'),
+        '    out = state.dcBlocker.process( out );',
+        '    return out * GLOBAL_VCA;',
+        '}',
+        '',
+        'static void render_kernel( const float* values, float sampleRate, float* out, int frames, Clock::duration& elapsed )',
+        '{',
+        '    four::EngineState state;',
+        '    four::engine_set_sample_rate( state, sampleRate );',
+        '    four::EngineParams params = four::panel_engine_params( values );',
+        '    float freq[4];',
+        '    four::engine_calc_frequencies( params, freq );',
+        '    const float osTime = ( 1.f / sampleRate ) / (float)OVERSAMPLE;',
+    ]
+    if any_modulated:
+        lines += [
+            '    four::ModParams modParams;',
+            '    four::ModState modState;',
+            '    four::panel_mod_params( values, modParams );',
+            '    float dt = BLOCK / sampleRate;',
+        ]
+    lines += [
+        '',
+        '    Clock::time_point t0 = Clock::now();',
+        '    for ( int pos = 0; pos < frames; pos += BLOCK )',
+        '    {',
+    ]
+    if any_modulated:
+        lines += [
+            '        float lfo[4], env[4];',
+            '        float offset[four::NUM_MOD_TARGETS][4];',
+            '        four::mod_sources_tick( modState, modParams, dt, false, lfo, env );',
+            '        four::mod_matrix( modParams, lfo, env, offset );',
+            '        four::engine_set_modulation( state, offset, BLOCK );',
+        ]
+    lines += [
+        '        int end = std::min( pos + BLOCK, frames );',
+        '        for ( int i = pos; i < end; i++ )',
+    ]
+    if any_modulated:
+        lines += [
+            '        {',
+            '            four::EngineParams m = params;',
+            '            if ( state.mod.active )',
+            '                four::engine_apply_modulation( state.mod, m );',
+            '            out[i] = kernel_process( state, freq, osTime, m );',
+            '        }',
+        ]
+    else:
+        lines.append('            out[i] = kernel_process( state, freq, osTime%s );' % (', params' if needs_params else ''))
+    lines += [
+        '    }',
+        '    elapsed = Clock::now() - t0;',
+        '}',
+        '',
+    ]
+
+
+# Vortex mode tables (see mode_filter2_type, mode_is_cascade, mode_is_morph
+# in src/Vortex/engine.h; the generated kernel checks them against the engine)
+VORTEX_TYPES = ['F2_LP', 'F2_LP', 'F2_LP', 'F2_HP', 'F2_HP', 'F2_HP', 'F2_BP', 'F2_BP',
+                'F2_NOTCH', 'F2_NOTCH', 'F2_AP', 'F2_AP', 'F2_LP', 'F2_LP']
+VORTEX_CASCADE = (2, 5, 7, 9, 11, 13)
+VORTEX_MORPH = (12, 13)
+
+
+def emit_vortex(lines, ids, saved):
+    def value(pid, default):
+        return saved.get(pid, default)
+
+    mode = int(value(ids['PANEL_MODE'], 0.0))
+    mode = max(0, min(13, mode))
+    drive = value(ids['PANEL_DRIVE'], 0.0)
+    follow = value(ids['PANEL_FOLLOW_AMOUNT'], 0.0)
+    fixed = value(ids['PANEL_FIXED_RATE'], 0.0) > 0.5
+    rate = int(value(ids['PANEL_FOLLOW_RATE'], 1.0))
+    division = 8 << max(0, min(3, rate))
+
+    first_order = mode in (0, 3)
+    cascade = mode in VORTEX_CASCADE
+    morph = mode in VORTEX_MORPH
+    ftype = VORTEX_TYPES[mode]
+    process = 'process_hb' if ftype in ('F2_HP', 'F2_BP') else 'process_lna'
+
+    # Filter members used by MODE and their slots in the engine's coefficient
+    # ramp (see engine_read_coefs)
+    if first_order:
+        members = [('f1', 'vortex::Filter1')]
+        coefs = [('f1.b0', 0), ('f1.b1', 1)]
+        states = ['f1.z']
+    else:
+        members = [('f2a', 'vortex::Filter2')] + ([('f2b', 'vortex::Filter2')] if cascade else [])
+        coefs = [('%s.b%d' % (name, b), base + b) for (name, _), base in zip(members, (2, 6)) for b in range(4)]
+        states = ['%s.z%d' % (name, z) for name, _ in members for z in range(2)]
+        if morph:
+            members.append(('morphZ0', 'float'))
+            coefs.append(('morphZ0', 10))
+
+    lines += [
+        '// Mode %d (%s%s%s); drive %s, follower %s' % (
+            mode, 'first order' if first_order else ftype[3:].lower(), ', cascade' if cascade else '',
+            ', morph' if morph else '', 'on' if drive > 0.0 else 'off', 'on' if follow != 0.0 else 'off'),
+        'static const int MODE = %d;' % mode,
+        'static const float DRIVE = %s;' % cfloat(drive),
+        'static const float DRIVE_GAIN = 1.0f + DRIVE * 9.0f;',
+        'static const float FOLLOW_AMOUNT = %s;' % cfloat(follow),
+        'static const int CONTROL_DIVISION = %d;' % division,
+        'static const bool FIXED_RATE = %s;' % ('true' if fixed else 'false'),
+        '',
+        '// Constants still match the engine and its mode tables',
+        'static bool kernel_matches( const vortex::EngineParams& p, const float* values )',
+        '{',
+        '    return p.mode == MODE && p.drive == DRIVE && p.followAmount == FOLLOW_AMOUNT',
+        '        && ( FOLLOW_AMOUNT == 0.f || p.controlDivision == CONTROL_DIVISION )',
+        '        && vortex::panel_fixed_rate( values ) == FIXED_RATE',
+        '        && vortex::mode_is_cascade( MODE ) == %s && vortex::mode_is_morph( MODE ) == %s%s;' % (
+            'true' if cascade else 'false', 'true' if morph else 'false',
+            '' if first_order else ' && vortex::mode_filter2_type( MODE ) == vortex::%s' % ftype),
+        '}',
+        '',
+        '// Engine params with the constant fields folded in',
+        'static inline vortex::EngineParams kernel_params( const vortex::EngineParams& params )',
+        '{',
+        '    vortex::EngineParams p = params;',
+        '    p.mode = MODE;',
+        '    p.drive = DRIVE;',
+        '    p.followAmount = FOLLOW_AMOUNT;',
+        '    return p;',
+        '}',
+        '',
+        '// The filter state and coefficients MODE uses, held in locals while rendering',
+        'struct KernelFilter',
+        '{',
+    ]
+    lines += ['    %s %s;' % (ctype, name) for name, ctype in members]
+    lines += [
+        '};',
+        '',
+        'static inline KernelFilter kernel_load( const vortex::EngineState& state )',
+        '{',
+        '    KernelFilter k;',
+    ]
+    lines += ['    k.%s = state.%s;' % (name, name) for name, _ in members]
+    lines += [
+        '    return k;',
+        '}',
+        '',
+        'static inline void kernel_store( const KernelFilter& k, vortex::EngineState& state )',
+        '{',
+    ]
+    lines += ['    state.%s = k.%s;' % (name, name) for name, _ in members]
+    lines += [
+        '}',
+        '',
+        '// Drive + filter one sample (same arithmetic as engine_tick for MODE)',
+        'static inline float kernel_tick( KernelFilter& k, float input )',
+        '{',
+        '    float signal = input;',
+    ]
+    if drive > 0.0:
+        lines.append('    signal = vortex::soft_clip( signal * DRIVE_GAIN );')
+    if first_order:
+        lines.append('    float wet = k.f1.%s( signal );' % ('process_lp' if mode == 0 else 'process_hp'))
+    elif morph:
+        lines.append('    float wet = vortex::filter2_process_morph( k.f2a, signal, k.morphZ0 );')
+        if cascade:
+            lines.append('    wet = vortex::filter2_process_morph( k.f2b, wet, k.morphZ0 );')
+    else:
+        lines.append('    float wet = k.f2a.%s( signal );' % process)
+        if cascade:
+            lines.append('    wet = k.f2b.%s( wet );' % process)
+    lines += ['    k.%s = vortex::flush_denormal( k.%s );' % (z, z) for z in states]
+    lines += [
+        '    return wet;',
+        '}',
+        '',
+    ]
+
+    if follow != 0.0:
+        lines += [
+            '// Advance the coefficient ramp by one sample (engine_process_follow)',
+            'static inline void kernel_ramp( KernelFilter& k, const float step[vortex::NUM_COEFS] )',
+            '{',
+        ]
+        lines += ['    k.%s += step[%d];' % (name, slot) for name, slot in coefs]
+        lines += [
+            '}',
+            '',
+            '// One sample with the follower: new coefficients every CONTROL_DIVISION',
+            '// samples through the engine, ramped here in between',
+            'static inline float kernel_follow( vortex::EngineState& state, KernelFilter& k, float step[vortex::NUM_COEFS],',
+            '                                   int& counter, const vortex::EngineParams& p, float rate, float input )',
+            '{',
+            '    state.follower.process( input );',
+            '    state.follower.env = vortex::flush_denormal( state.follower.env );',
+            '    if ( counter <= 0 )',
+            '    {',
+            '        kernel_store( k, state );',
+            '        vortex::engine_follow_update( state, p, rate, state.follower.env );',
+            '        k = kernel_load( state );',
+            '        for ( int c = 0; c < vortex::NUM_COEFS; c++ )',
+            '            step[c] = state.coefStep[c];',
+            '        counter = CONTROL_DIVISION;',
+            '    }',
+            '    counter--;',
+            '    float wet = kernel_tick( k, input );',
+            '    kernel_ramp( k, step );',
+            '    return wet;',
+            '}',
+            '',
+        ]
+        sample = 'kernel_follow( state, k, step, counter, p, %s, %s )'
+    else:
+        sample = 'kernel_tick( k, %s%s )'
+
+    lines += [
+        'static void render_kernel( const float* values, float sampleRate, const float* in, float* out, int frames,',
+        '                           Clock::duration& elapsed )',
+        '{',
+        '    vortex::EngineState state;',
+        '    vortex::FixedRateState fixed;',
+        '    const vortex::EngineParams p = kernel_params( vortex::panel_engine_params( values ) );',
+        '    vortex::engine_configure_fixed_rate( state, fixed, sampleRate, FIXED_RATE );',
+        '    const float rate = fixed.internalRate;',
+        '',
+        '    Clock::time_point t0 = Clock::now();',
+    ]
+    if follow != 0.0:
+        lines += [
+            '    state.follower.configure( rate, p.followAttack, p.followRelease );',
+            '    KernelFilter k = kernel_load( state );',
+            '    float step[vortex::NUM_COEFS] = {};',
+            '    int counter = 0;',
+        ]
+    else:
+        lines += [
+            '    vortex::engine_update_mode( state, MODE );',
+            '    vortex::engine_configure( state, p, rate );',
+            '    KernelFilter k = kernel_load( state );',
+        ]
+    if fixed:
+        lines += [
+            '    if ( fixed.active() )',
+            '    {',
+            '        for ( int i = 0; i < frames; i++ )',
+            '        {',
+            '            float x;',
+            '            if ( fixed.resampler.decimate( in[i], x ) )',
+            '                fixed.resampler.interpolate_push( %s );' % (
+                sample % ('rate', 'x') if follow != 0.0 else sample % ('x', '')),
+            '            out[i] = fixed.resampler.interpolate_pull();',
+            '        }',
+            '        elapsed = Clock::now() - t0;',
+            '        return;',
+            '    }',
+        ]
+    lines += [
+        '    for ( int i = 0; i < frames; i++ )',
+        '        out[i] = %s;' % (sample % ('rate', 'in[i]') if follow != 0.0 else sample % ('in[i]', '')),
+        '    elapsed = Clock::now() - t0;',
+        '}',
+        '',
+    ]
+
+
+def emit_main(lines, model, is_four):
+    ns = 'four' if is_four else 'vortex'
+    lines += [
+        '// Usage: <kernel> [seconds] [sampleRate] [output.wav]',
+        'int main( int argc, char** argv )',
+        '{',
+        '    float seconds = argc > 1 ? (float)atof( argv[1] ) : 10.f;',
+        '    float sampleRate = argc > 2 ? (float)atof( argv[2] ) : 48000.f;',
+        '    if ( seconds <= 0.f || sampleRate <= 0.f )',
+        '    {',
+        '        fprintf( stderr, "seconds and sampleRate must be positive\\n" );',
+        '        return 1;',
+        '    }',
+        '',
+        '    // Read the saved values through volatile so the generic path cannot be',
+        '    // specialized by the compiler as well',
+        '    std::vector<PanelValue> saved;',
+        '    for ( int i = 0; i < SAVED_COUNT; i++ )',
+        '    {',
+        '        PanelValue v;',
+        '        v.id = *(volatile const int*)&SAVED[i].id;',
+        '        v.value = *(volatile const float*)&SAVED[i].value;',
+        '        saved.push_back( v );',
+        '    }',
+        '    float values[%s::PANEL_PARAMS_LEN];' % ns,
+        '    %s::panel_defaults( values );' % ns,
+        '    apply_params( saved, values, %s::PANEL_PARAMS_LEN );' % ns,
+        '',
+        '    if ( !kernel_matches( %s::panel_engine_params( values )%s ) )' % (ns, '' if is_four else ', values'),
+        '    {',
+        '        fprintf( stderr, "kernel constants do not match the engine; regenerate the kernel\\n" );',
+        '        return 1;',
+        '    }',
+        '',
+        '    int frames = (int)( seconds * sampleRate );',
+        '    std::vector<float> generic( frames ), kernel( frames );',
+        '    Clock::duration genericTime, kernelTime;',
+    ]
+    if is_four:
+        lines += [
+            '    render_four( values, sampleRate, generic.data(), frames, genericTime );',
+            '    render_kernel( values, sampleRate, kernel.data(), frames, kernelTime );',
+        ]
+    else:
+        lines += [
+            '    std::vector<float> in( frames );',
+            '    render_vortex_input( sampleRate, in.data(), frames );',
+            '    render_vortex( values, sampleRate, in.data(), generic.data(), frames, genericTime );',
+            '    render_kernel( values, sampleRate, in.data(), kernel.data(), frames, kernelTime );',
+        ]
+    lines += [
+        '',
+        '    float maxDiff = 0.f;',
+        '    for ( int i = 0; i < frames; i++ )',
+        '        maxDiff = std::max( maxDiff, fabsf( generic[i] - kernel[i] ) );',
+        '',
+        '    double genericNs = std::chrono::duration<double>( genericTime ).count() * 1e9 / frames;',
+        '    double kernelNs = std::chrono::duration<double>( kernelTime ).count() * 1e9 / frames;',
+        '    printf( "%s: %%d frames (%%.2f s at %%.0f Hz)\\n", frames, seconds, sampleRate );' % model,
+        '    printf( "generic: %.1f ns/sample\\n", genericNs );',
+        '    printf( "kernel: %.1f ns/sample\\n", kernelNs );',
+        '    printf( "speedup: %.2fx, max difference %g\\n", kernelNs > 0.0 ? genericNs / kernelNs : 0.0, maxDiff );',
+        '',
+        '    if ( !( maxDiff <= %s ) )' % TOLERANCE,
+        '    {',
+        '        fprintf( stderr, "kernel output differs from the generic engine\\n" );',
+        '        return 1;',
+        '    }',
+        '    if ( argc > 3 && !wintoid::write_wav( argv[3], kernel.data(), (uint32_t)frames, (uint32_t)sampleRate ) )',
+        '    {',
+        '        fprintf( stderr, "%s: write failed\\n", argv[3] );',
+        '        return 1;',
+        '    }',
+        '    return 0;',
+        '}',
+    ]
+
+
+def generate(project_dir, params_path):
+    model, saved = read_params(params_path)
+    lines = []
+    emit_header(lines, params_path, model, saved)
+    if model == 'FourMM':
+        ids = read_enum(os.path.join(project_dir, 'src', 'Four', 'panel.h'), 'PanelParamId')
+        algorithms = read_algorithms(os.path.join(project_dir, 'src', 'Four', 'dsp.h'))
+        emit_four(lines, ids, saved, algorithms)
+    elif model == 'VortexMM':
+        ids = read_enum(os.path.join(project_dir, 'src', 'Vortex', 'panel.h'), 'PanelParamId')
+        emit_vortex(lines, ids, saved)
+    else:
+        raise ValueError('%s: unsupported model %r' % (params_path, model))
+    emit_main(lines, model, model == 'FourMM')
+    return '\n'.join(lines) + '\n'
+
+
+if __name__ == '__main__':
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    project_dir = os.path.dirname(script_dir)
+
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('params', help='params file from scripts/render_patch.py')
+    parser.add_argument('-o', '--output', help='generated C++ file')
+    parser.add_argument('--run', action='store_true', help='compile and run the kernel')
+    parser.add_argument('--seconds', type=float, default=10.0)
+    parser.add_argument('--rate', type=float, default=48000.0, help='sample rate')
+    parser.add_argument('--wav', help='write the kernel output to this WAV (with --run)')
+    args = parser.parse_args()
+
+    output = args.output or os.path.splitext(args.params)[0] + '.kernel.cpp'
+    with open(output, 'w') as f:
+        f.write(generate(project_dir, args.params))
+    print('wrote', output)
+
+    if args.run:
+        binary = os.path.abspath(os.path.splitext(output)[0])
+        subprocess.run([os.environ.get('CXX', 'c++'), '-std=c++11', '-O2',
+                        '-I', os.path.join(project_dir, 'tools'),
+                        '-o', binary, output, '-lm'], check=True)
+        command = [binary, str(args.seconds), str(args.rate)] + ([args.wav] if args.wav else [])
+        sys.exit(subprocess.run(command).returncode)
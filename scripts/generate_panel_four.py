@@ -71,12 +71,14 @@ GLOBAL_CONTROLS = {
     # Row 1 (Y_GLOBAL_ROW1 = 22.0)
     'voct_jack':     (20.0, Y_GLOBAL_ROW1),
     'fine_tune_knob': (WIDTH_MM / 2, Y_GLOBAL_ROW1),
+    'gate_jack':     (88.0, Y_GLOBAL_ROW1),               # built-in envelope gate
     'vca_knob':      (WIDTH_MM - 27.0, Y_GLOBAL_ROW1),   # moved left to make room for output
     'main_output':   (WIDTH_MM - 18.0, Y_GLOBAL_ROW1),   # right of VCA
     # Row 2 (Y_GLOBAL_ROW2 = 33.0)
     'xm_knob':       (20.0, Y_GLOBAL_ROW2),
     'xm_cv_jack':    (29.0, Y_GLOBAL_ROW2),
     'xm_cv_atten':   (37.0, Y_GLOBAL_ROW2),
+    'algo_cv_jack':  (WIDTH_MM / 2, Y_GLOBAL_ROW2),      # below Fine
     'fm_cv_jack':    (WIDTH_MM - 18.0 - 9.0, Y_GLOBAL_ROW2),
     'fm_cv_atten':   (WIDTH_MM - 18.0, Y_GLOBAL_ROW2),
 }
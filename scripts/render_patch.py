@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Render every Four and Vortex instance in a saved VCV Rack patch.
+
+Run from project root (after `make -C tools`):
+    python3 scripts/render_patch.py my_patch.vcv [-o renders] [--seconds 10]
+
+Each instance's saved panel values are passed to tools/render, which runs the
+headless engine (no cables: Four plays C4, Vortex filters a 110 Hz saw) and
+writes <outdir>/<index>_<model>_<module id>.wav. Instances render in
+parallel. The per-instance cost table printed at the end comes from a
+separate serial pass (--time-seconds of audio per instance), so each figure
+is measured without the other renders competing for cores, caches and
+memory bandwidth. With --jobs 1 the WAV renders are timed directly.
+
+Rack 2 patches are zstd-compressed tar archives; they are unpacked with the
+system `zstd` (or `tar --zstd`). Uncompressed tar and legacy plain-JSON
+patches are read directly.
+"""
+
+import argparse
+import concurrent.futures
+import io
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tarfile
+import tempfile
+
+PLUGIN_SLUG = 'wintoid'
+MODELS = ('FourMM', 'VortexMM')
+ZSTD_MAGIC = b'\x28\xb5\x2f\xfd'
+
+
+def decompress_zstd(path):
+    if shutil.which('zstd'):
+        return subprocess.run(['zstd', '-dc', path], check=True,
+                              stdout=subprocess.PIPE).stdout
+    # GNU tar can call its own zstd support
+    return subprocess.run(['tar', '--zstd', '-xOf', path, 'patch.json'], check=True,
+                          stdout=subprocess.PIPE).stdout
+
+
+def read_patch_json(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data.lstrip()[:1] == b'{':
+        return json.loads(data.decode('utf-8'))
+
+    if data[:4] == ZSTD_MAGIC:
+        data = decompress_zstd(path)
+        if data.lstrip()[:1] == b'{':    # tar --zstd already extracted patch.json
+            return json.loads(data.decode('utf-8'))
+
+    with tarfile.open(fileobj=io.BytesIO(data)) as tar:
+        for member in tar.getmembers():
+            if os.path.basename(member.name) == 'patch.json':
+                return json.loads(tar.extractfile(member).read().decode('utf-8'))
+    raise ValueError('%s: no patch.json in archive' % path)
+
+
+def find_instances(patch):
+    instances = []
+    for module in patch.get('modules', []):
+        if module.get('plugin') == PLUGIN_SLUG and module.get('model') in MODELS:
+            instances.append(module)
+    return instances
+
+
+def write_params(path, module):
+    with open(path, 'w') as f:
+        f.write(module['model'] + '\n')
+        for param in module.get('params', []):
+            if 'id' in param and 'value' in param:
+                f.write('%d %.9g\n' % (param['id'], param['value']))
+
+
+def render(render_bin, params_path, wav_path, seconds, rate):
+    result = subprocess.run([render_bin, params_path, wav_path, str(seconds), str(rate)],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        return None, result.stderr.strip()
+    match = re.search(r'render: ([0-9.]+) ns/sample, ([0-9.]+)x realtime', result.stdout)
+    if not match:
+        return None, 'unexpected output: ' + result.stdout.strip()
+    return (float(match.group(1)), float(match.group(2))), None
+
+
+if __name__ == '__main__':
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+    project_dir = os.path.dirname(script_dir)
+
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('patch', help='saved .vcv patch')
+    parser.add_argument('-o', '--outdir', default='renders', help='output directory')
+    parser.add_argument('--seconds', type=float, default=10.0)
+    parser.add_argument('--rate', type=float, default=48000.0, help='sample rate')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1,
+                        help='parallel renders for the WAVs')
+    parser.add_argument('--time-seconds', type=float, default=2.0,
+                        help='audio rendered per instance in the serial timing pass')
+    args = parser.parse_args()
+
+    render_bin = os.path.join(project_dir, 'tools', 'render')
+    if not os.path.exists(render_bin):
+        sys.exit('%s not found; run `make -C tools` first' % render_bin)
+
+    instances = find_instances(read_patch_json(args.patch))
+    if not instances:
+        sys.exit('%s: no Four or Vortex instances' % args.patch)
+    os.makedirs(args.outdir, exist_ok=True)
+
+    jobs = []
+    for index, module in enumerate(instances):
+        name = '%02d_%s_%s' % (index, module['model'], module.get('id', index))
+        params_path = os.path.join(args.outdir, name + '.params')
+        wav_path = os.path.join(args.outdir, name + '.wav')
+        write_params(params_path, module)
+        jobs.append((name, params_path, wav_path))
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        futures = [pool.submit(render, render_bin, p, w, args.seconds, args.rate)
+                   for _, p, w in jobs]
+        results = [f.result() for f in futures]
+
+    # Concurrent renders slow each other down; time each instance on its own
+    if args.jobs > 1:
+        with tempfile.TemporaryDirectory() as tmp:
+            scratch = os.path.join(tmp, 'timing.wav')
+            results = [render(render_bin, p, scratch, args.time_seconds, args.rate) if not error else (cost, error)
+                       for (_, p, _), (cost, error) in zip(jobs, results)]
+
+    failed = 0
+    print('%-32s %12s %10s  %s' % ('instance', 'ns/sample', 'realtime', 'output'))
+    for (name, _, wav_path), (cost, error) in zip(jobs, results):
+        if error:
+            failed += 1
+            print('%-32s %12s %10s  %s' % (name, '-', '-', error))
+        else:
+            print('%-32s %12.1f %9.1fx  %s' % (name, cost[0], cost[1], wav_path))
+    sys.exit(1 if failed else 0)
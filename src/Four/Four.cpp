@@ -1,5 +1,8 @@
 #include "../plugin.hpp"
 #include "engine.h"
+#include "panel.h"
+#include "../capture.h"
+#include "../snapshot.h"
 
 struct CoarseParamQuantity : ParamQuantity {
     int freqModeParamId = 0;
@@ -53,6 +56,24 @@ struct Four : Module {
         OP1_FREQ_MODE_PARAM, OP2_FREQ_MODE_PARAM, OP3_FREQ_MODE_PARAM, OP4_FREQ_MODE_PARAM,
         OP1_FOLD_TYPE_PARAM, OP2_FOLD_TYPE_PARAM, OP3_FOLD_TYPE_PARAM, OP4_FOLD_TYPE_PARAM,
 
+        // Hidden built-in modulation sources (right-click menu / MetaModule)
+        OP1_LFO_RATE_PARAM,   OP2_LFO_RATE_PARAM,   OP3_LFO_RATE_PARAM,   OP4_LFO_RATE_PARAM,
+        OP1_ENV_ATTACK_PARAM, OP2_ENV_ATTACK_PARAM, OP3_ENV_ATTACK_PARAM, OP4_ENV_ATTACK_PARAM,
+        OP1_ENV_DECAY_PARAM,  OP2_ENV_DECAY_PARAM,  OP3_ENV_DECAY_PARAM,  OP4_ENV_DECAY_PARAM,
+
+        // Hidden routing amounts, source > target (see modAmountParam)
+        OP1_LFO_LEVEL_PARAM, OP2_LFO_LEVEL_PARAM, OP3_LFO_LEVEL_PARAM, OP4_LFO_LEVEL_PARAM,
+        OP1_LFO_WARP_PARAM,  OP2_LFO_WARP_PARAM,  OP3_LFO_WARP_PARAM,  OP4_LFO_WARP_PARAM,
+        OP1_LFO_FOLD_PARAM,  OP2_LFO_FOLD_PARAM,  OP3_LFO_FOLD_PARAM,  OP4_LFO_FOLD_PARAM,
+        OP1_LFO_FB_PARAM,    OP2_LFO_FB_PARAM,    OP3_LFO_FB_PARAM,    OP4_LFO_FB_PARAM,
+        OP1_ENV_LEVEL_PARAM, OP2_ENV_LEVEL_PARAM, OP3_ENV_LEVEL_PARAM, OP4_ENV_LEVEL_PARAM,
+        OP1_ENV_WARP_PARAM,  OP2_ENV_WARP_PARAM,  OP3_ENV_WARP_PARAM,  OP4_ENV_WARP_PARAM,
+        OP1_ENV_FOLD_PARAM,  OP2_ENV_FOLD_PARAM,  OP3_ENV_FOLD_PARAM,  OP4_ENV_FOLD_PARAM,
+        OP1_ENV_FB_PARAM,    OP2_ENV_FB_PARAM,    OP3_ENV_FB_PARAM,    OP4_ENV_FB_PARAM,
+
+        // Anti-aliasing (hidden, context menu): 2x, 2x + alias guard, 1x + alias guard
+        ANTIALIAS_PARAM,
+
         PARAMS_LEN
     };
     enum InputId {
@@ -67,6 +88,12 @@ struct Four : Module {
         OP1_FOLD_CV_INPUT,  OP2_FOLD_CV_INPUT,  OP3_FOLD_CV_INPUT,  OP4_FOLD_CV_INPUT,
         OP1_FB_CV_INPUT,    OP2_FB_CV_INPUT,    OP3_FB_CV_INPUT,    OP4_FB_CV_INPUT,
 
+        // Algorithm CV (1V per algorithm, added to the knob)
+        ALGO_CV_INPUT,
+
+        // Gate: rising edge restarts the built-in envelopes
+        GATE_INPUT,
+
         INPUTS_LEN
     };
     enum OutputId {
@@ -79,6 +106,42 @@ struct Four : Module {
 
     four::EngineState engineState;
 
+    // Settings edited from the UI (displays, menus, knobs). Derived engine
+    // values are recomputed only when these change. Plain data, compared with memcmp.
+    struct Settings {
+        int algorithm = 0;
+        int freqMode[4] = {};
+        int foldType[4] = {};
+        float coarse[4] = {};
+        float fineCents[4] = {};
+        float globalFineCents = 0.f;
+        int antialias = 0;
+    };
+
+    wintoid::SnapshotBuffer<Settings> settingsBuffer;
+    uint32_t settingsSeen = 0;
+    Settings settings;
+    dsp::ClockDivider settingsDivider;
+
+    // Derived from settings
+    float opCoarse[4] = {};
+    float opFineMult[4] = {};
+    float globalFineMult = 1.f;
+
+    // Built-in modulation: sources and routing run every MOD_CONTROL_DIVISION
+    // samples, the engine ramps the resulting offsets per sample
+    four::ModParams modParams;
+    four::ModState modState;
+    dsp::ClockDivider modDivider;
+    dsp::SchmittTrigger gateTrigger;
+    bool gateTriggered = false;
+
+    // Algorithm after CV, for AlgoDisplay
+    int activeAlgorithm = 0;
+
+    // Hidden input capture (context menu > Developer), ~0.7s of buffering at 48kHz
+    wintoid::CaptureRecorder capture { four::CAPTURE_CHANNELS, 1 << 15 };
+
     Four() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 
@@ -145,96 +208,211 @@ struct Four : Module {
         configInput(VOCT_INPUT, "V/OCT");
         configInput(EXT_PM_CV_INPUT, "Ext PM");
         configInput(XM_CV_INPUT, "Mod CV");
+        configInput(ALGO_CV_INPUT, "Algorithm CV (0-10V)");
+        configInput(GATE_INPUT, "Envelope gate");
+
+        // Built-in modulation (hidden)
+        const char* sourceNames[] = { "LFO", "Env" };
+        const char* targetNames[] = { "Level", "Warp", "Fold", "Feedback" };
+        for ( int i = 0; i < 4; i++ )
+        {
+            std::string n = std::to_string( i + 1 );
+            configParam(OP1_LFO_RATE_PARAM + i, log2f(0.01f), log2f(20.f), 0.f, "Op " + n + " LFO Rate", " Hz", 2.f);
+            configParam(OP1_ENV_ATTACK_PARAM + i, log2f(0.001f), log2f(10.f), log2f(0.01f), "Op " + n + " Env Attack", " ms", 2.f, 1000.f);
+            configParam(OP1_ENV_DECAY_PARAM + i, log2f(0.001f), log2f(10.f), log2f(0.5f), "Op " + n + " Env Decay", " ms", 2.f, 1000.f);
+
+            for ( int src = 0; src < four::NUM_MOD_SOURCES; src++ )
+                for ( int t = 0; t < four::NUM_MOD_TARGETS; t++ )
+                    configParam(modAmountParam(src, t, i), -1.f, 1.f, 0.f,
+                                "Op " + n + " " + sourceNames[src] + " > " + targetNames[t], "%", 0.f, 100.f);
+        }
+
+        configSwitch(ANTIALIAS_PARAM, 0.f, 2.f, 0.f, "Anti-aliasing",
+                     {"2x oversampling", "2x + alias guard", "1x + alias guard"});
 
         // Output
         configOutput(MAIN_OUTPUT, "Main");
+
+        settingsDivider.setDivision(32);
+        applySettings(readSettings());
+        modDivider.setDivision(four::MOD_CONTROL_DIVISION);
+    }
+
+    static int modAmountParam(int source, int target, int op) {
+        return OP1_LFO_LEVEL_PARAM + ( source * four::NUM_MOD_TARGETS + target ) * 4 + op;
+    }
+
+    // Control rate: read the modulation params, advance the sources and
+    // start a new engine ramp toward the routed offsets
+    void updateModulation(float sampleTime) {
+        bool trigger = gateTriggered;
+        gateTriggered = false;
+
+        for ( int i = 0; i < 4; i++ )
+            for ( int src = 0; src < four::NUM_MOD_SOURCES; src++ )
+                for ( int t = 0; t < four::NUM_MOD_TARGETS; t++ )
+                    modParams.amount[src][t][i] = params[modAmountParam(src, t, i)].getValue();
+
+        // Nothing routed and nothing left to ramp down
+        if ( !four::mod_params_active( modParams ) && !engineState.mod.active )
+            return;
+
+        for ( int i = 0; i < 4; i++ )
+            four::panel_mod_times( modParams, i, params[OP1_LFO_RATE_PARAM + i].getValue(),
+                                   params[OP1_ENV_ATTACK_PARAM + i].getValue(),
+                                   params[OP1_ENV_DECAY_PARAM + i].getValue() );
+
+        float lfo[4], env[4];
+        float offset[four::NUM_MOD_TARGETS][4];
+        four::mod_sources_tick( modState, modParams, sampleTime * four::MOD_CONTROL_DIVISION, trigger, lfo, env );
+        four::mod_matrix( modParams, lfo, env, offset );
+        four::engine_set_modulation( engineState, offset, four::MOD_CONTROL_DIVISION );
+    }
+
+    // Reads the UI-edited settings from params (UI or audio thread)
+    Settings readSettings() {
+        Settings st;
+        st.algorithm = (int)params[ALGO_PARAM].getValue();
+        st.globalFineCents = params[FINE_TUNE_PARAM].getValue();
+        st.antialias = (int)params[ANTIALIAS_PARAM].getValue();
+        for ( int i = 0; i < 4; i++ )
+        {
+            st.freqMode[i] = (int)params[OP1_FREQ_MODE_PARAM + i].getValue();
+            st.foldType[i] = (int)params[OP1_FOLD_TYPE_PARAM + i].getValue();
+            st.coarse[i] = params[OP1_COARSE_PARAM + i].getValue();
+            st.fineCents[i] = params[OP1_FINE_PARAM + i].getValue();
+        }
+        return st;
+    }
+
+    // UI thread: publish settings after a widget edits params directly
+    void publishSettings() {
+        settingsBuffer.publish( readSettings() );
+    }
+
+    // Audio thread: recompute derived engine values
+    void applySettings(const Settings& st) {
+        settings = st;
+        globalFineMult = four::panel_fine_mult( st.globalFineCents );
+        for ( int i = 0; i < 4; i++ )
+        {
+            opCoarse[i] = four::panel_coarse( st.freqMode[i], st.coarse[i] );
+            opFineMult[i] = four::panel_fine_mult( st.fineCents[i] );
+        }
+    }
+
+    void onSampleRateChange(const SampleRateChangeEvent& e) override {
+        four::engine_set_sample_rate( engineState, e.sampleRate );
     }
 
     void process(const ProcessArgs& args) override {
+        // Widget edits arrive as versioned snapshots (one atomic load per
+        // sample); knob moves, presets and undo are caught by a control-rate rescan.
+        Settings pending;
+        if ( settingsBuffer.poll( settingsSeen, pending ) )
+            applySettings( pending );
+        else if ( settingsDivider.process() )
+        {
+            Settings st = readSettings();
+            if ( memcmp( &st, &settings, sizeof( Settings ) ) != 0 )
+                applySettings( st );
+        }
+
+        // Built-in modulation: gate edges are caught per sample, sources run at control rate
+        if ( gateTrigger.process( inputs[GATE_INPUT].getVoltage(), 0.1f, 1.f ) )
+            gateTriggered = true;
+        if ( modDivider.process() )
+            updateModulation( args.sampleTime );
+
         four::EngineParams ep;
 
         // --- Global params ---
-        ep.algorithm = (int)params[ALGO_PARAM].getValue();
+        // Algorithm: knob + 1V per step, switchable every sample
+        ep.algorithm = four::panel_algorithm( (float)settings.algorithm, inputs[ALGO_CV_INPUT].getVoltage() );
+        activeAlgorithm = ep.algorithm;
         ep.globalVCA = params[VCA_PARAM].getValue();
-
-        float globalFineCents = params[FINE_TUNE_PARAM].getValue();
-        float globalFineMult = exp2f( globalFineCents / 1200.f );
+        four::engine_set_antialias( ep, settings.antialias );
 
         // V/OCT: base voltage
         float voct = inputs[VOCT_INPUT].getVoltage();
         ep.baseFreq = four::voct_to_freq( voct ) * globalFineMult;
 
         // Mod: knob + attenuated CV
-        float modCv = inputs[XM_CV_INPUT].getVoltage() * params[XM_CV_ATTEN_PARAM].getValue() / 10.f;
-        ep.modMaster = clamp( params[XM_PARAM].getValue() + modCv, 0.f, 1.f );
+        ep.modMaster = four::panel_unipolar( params[XM_PARAM].getValue(), inputs[XM_CV_INPUT].getVoltage(),
+                                             params[XM_CV_ATTEN_PARAM].getValue() );
 
         // Ext PM: attenuated CV only (no depth knob)
-        float extPmCv = inputs[EXT_PM_CV_INPUT].getVoltage() * params[EXT_PM_CV_ATTEN_PARAM].getValue();
-        ep.extPmDepth = clamp(extPmCv, 0.f, 1.f);
+        ep.extPmDepth = four::panel_ext_pm_depth( inputs[EXT_PM_CV_INPUT].getVoltage(),
+                                                  params[EXT_PM_CV_ATTEN_PARAM].getValue() );
 
         // --- Per-operator params ---
-        const int coarseIds[] = { OP1_COARSE_PARAM, OP2_COARSE_PARAM, OP3_COARSE_PARAM, OP4_COARSE_PARAM };
-        const int fineIds[]   = { OP1_FINE_PARAM, OP2_FINE_PARAM, OP3_FINE_PARAM, OP4_FINE_PARAM };
-        const int levelIds[]  = { OP1_LEVEL_PARAM, OP2_LEVEL_PARAM, OP3_LEVEL_PARAM, OP4_LEVEL_PARAM };
-        const int warpIds[]   = { OP1_WARP_PARAM, OP2_WARP_PARAM, OP3_WARP_PARAM, OP4_WARP_PARAM };
-        const int foldIds[]   = { OP1_FOLD_PARAM, OP2_FOLD_PARAM, OP3_FOLD_PARAM, OP4_FOLD_PARAM };
-        const int fbIds[]     = { OP1_FB_PARAM, OP2_FB_PARAM, OP3_FB_PARAM, OP4_FB_PARAM };
-        const int freqModeIds[] = { OP1_FREQ_MODE_PARAM, OP2_FREQ_MODE_PARAM, OP3_FREQ_MODE_PARAM, OP4_FREQ_MODE_PARAM };
-        const int foldTypeIds[] = { OP1_FOLD_TYPE_PARAM, OP2_FOLD_TYPE_PARAM, OP3_FOLD_TYPE_PARAM, OP4_FOLD_TYPE_PARAM };
-
-        const int levelCvIds[] = { OP1_LEVEL_CV_INPUT, OP2_LEVEL_CV_INPUT, OP3_LEVEL_CV_INPUT, OP4_LEVEL_CV_INPUT };
-        const int warpCvIds[]  = { OP1_WARP_CV_INPUT, OP2_WARP_CV_INPUT, OP3_WARP_CV_INPUT, OP4_WARP_CV_INPUT };
-        const int foldCvIds[]  = { OP1_FOLD_CV_INPUT, OP2_FOLD_CV_INPUT, OP3_FOLD_CV_INPUT, OP4_FOLD_CV_INPUT };
-        const int fbCvIds[]    = { OP1_FB_CV_INPUT, OP2_FB_CV_INPUT, OP3_FB_CV_INPUT, OP4_FB_CV_INPUT };
-
-        const int levelCvAIds[] = { OP1_LEVEL_CV_ATTEN_PARAM, OP2_LEVEL_CV_ATTEN_PARAM, OP3_LEVEL_CV_ATTEN_PARAM, OP4_LEVEL_CV_ATTEN_PARAM };
-        const int warpCvAIds[]  = { OP1_WARP_CV_ATTEN_PARAM, OP2_WARP_CV_ATTEN_PARAM, OP3_WARP_CV_ATTEN_PARAM, OP4_WARP_CV_ATTEN_PARAM };
-        const int foldCvAIds[]  = { OP1_FOLD_CV_ATTEN_PARAM, OP2_FOLD_CV_ATTEN_PARAM, OP3_FOLD_CV_ATTEN_PARAM, OP4_FOLD_CV_ATTEN_PARAM };
-        const int fbCvAIds[]    = { OP1_FB_CV_ATTEN_PARAM, OP2_FB_CV_ATTEN_PARAM, OP3_FB_CV_ATTEN_PARAM, OP4_FB_CV_ATTEN_PARAM };
-
         for ( int i = 0; i < 4; i++ )
         {
-            int freqMode = (int)params[freqModeIds[i]].getValue();
-            ep.opFreqMode[i] = freqMode;
-            ep.opFoldType[i] = (int)params[foldTypeIds[i]].getValue();
-
-            // Coarse: index->ratio in ratio mode, index->Hz in fixed mode
-            float coarseParam = params[coarseIds[i]].getValue();
-            if ( freqMode == 0 )
-                ep.opCoarse[i] = four::coarse_ratio_from_index( (int)roundf(coarseParam) );
-            else
-                ep.opCoarse[i] = four::coarse_fixed_from_param( coarseParam );
-
-            // Fine: cents -> multiplier
-            ep.opFine[i] = exp2f( params[fineIds[i]].getValue() / 1200.f );
-
-            // Level + CV
-            float levelCv = inputs[levelCvIds[i]].getVoltage() * params[levelCvAIds[i]].getValue() / 10.f;
-            ep.opLevel[i] = clamp( params[levelIds[i]].getValue() + levelCv, 0.f, 1.f );
-
-            // Warp + CV
-            float warpCv = inputs[warpCvIds[i]].getVoltage() * params[warpCvAIds[i]].getValue() / 10.f;
-            ep.opWarp[i] = clamp( params[warpIds[i]].getValue() + warpCv, 0.f, 1.f );
-
-            // Fold + CV
-            float foldCv = inputs[foldCvIds[i]].getVoltage() * params[foldCvAIds[i]].getValue() / 10.f;
-            ep.opFold[i] = clamp( params[foldIds[i]].getValue() + foldCv, 0.f, 1.f );
-
-            // Feedback + CV
-            float fbCv = inputs[fbCvIds[i]].getVoltage() * params[fbCvAIds[i]].getValue() / 10.f;
-            ep.opFeedback[i] = clamp( params[fbIds[i]].getValue() + fbCv, 0.f, 1.f );
+            ep.opFreqMode[i] = settings.freqMode[i];
+            ep.opFoldType[i] = settings.foldType[i];
+            ep.opCoarse[i] = opCoarse[i];
+            ep.opFine[i] = opFineMult[i];
+
+            // Level, warp, fold, feedback: knob + attenuated CV
+            ep.opLevel[i] = four::panel_unipolar( params[OP1_LEVEL_PARAM + i].getValue(),
+                                                  inputs[OP1_LEVEL_CV_INPUT + i].getVoltage(),
+                                                  params[OP1_LEVEL_CV_ATTEN_PARAM + i].getValue() );
+            ep.opWarp[i] = four::panel_unipolar( params[OP1_WARP_PARAM + i].getValue(),
+                                                 inputs[OP1_WARP_CV_INPUT + i].getVoltage(),
+                                                 params[OP1_WARP_CV_ATTEN_PARAM + i].getValue() );
+            ep.opFold[i] = four::panel_unipolar( params[OP1_FOLD_PARAM + i].getValue(),
+                                                 inputs[OP1_FOLD_CV_INPUT + i].getVoltage(),
+                                                 params[OP1_FOLD_CV_ATTEN_PARAM + i].getValue() );
+            ep.opFeedback[i] = four::panel_unipolar( params[OP1_FB_PARAM + i].getValue(),
+                                                     inputs[OP1_FB_CV_INPUT + i].getVoltage(),
+                                                     params[OP1_FB_CV_ATTEN_PARAM + i].getValue() );
         }
 
         // --- Run engine ---
         float extPm = inputs[EXT_PM_CV_INPUT].getVoltage();  // Audio-rate PM input
-        float out = four::engine_process( engineState, ep, args.sampleTime, extPm );
+
+        // Built-in modulation is folded into ep here rather than inside the
+        // engine, so a capture records the values the operators actually use
+        // and replays without the gate or the modulation settings
+        if ( engineState.mod.active )
+            four::engine_apply_modulation( engineState.mod, ep );
+
+        if ( capture.isRecording() )
+        {
+            float frame[four::CAPTURE_CHANNELS];
+            four::engine_capture_frame( ep, extPm, frame );
+            capture.record( frame );
+        }
+
+        float freq[4];
+        four::engine_calc_frequencies( ep, freq );
+        float out = four::engine_process_freq( engineState, ep, freq, args.sampleTime, extPm );
 
         // Scale to +/-5V
         outputs[MAIN_OUTPUT].setVoltage( out * 5.f );
     }
 
+    void setCapture(bool on) {
+        if ( on )
+            capture.start( capturePath( "Four", id ), "FOUR", APP->engine->getSampleRate() );
+        else
+            capture.stop();
+    }
+
 };
 
+// Patch param ids must match the offline renderer's layout (panel.h)
+static_assert(Four::OP1_COARSE_PARAM == four::PANEL_OP_COARSE, "panel.h out of date");
+static_assert(Four::OP1_FB_PARAM == four::PANEL_OP_FB, "panel.h out of date");
+static_assert(Four::XM_CV_ATTEN_PARAM == four::PANEL_XM_CV_ATTEN, "panel.h out of date");
+static_assert(Four::OP1_FB_CV_ATTEN_PARAM == four::PANEL_OP_FB_CV_ATTEN, "panel.h out of date");
+static_assert(Four::OP1_FREQ_MODE_PARAM == four::PANEL_OP_FREQ_MODE, "panel.h out of date");
+static_assert(Four::OP1_FOLD_TYPE_PARAM == four::PANEL_OP_FOLD_TYPE, "panel.h out of date");
+static_assert(Four::OP1_LFO_RATE_PARAM == four::PANEL_OP_LFO_RATE, "panel.h out of date");
+static_assert(Four::OP1_LFO_LEVEL_PARAM == four::PANEL_OP_MOD_AMOUNT, "panel.h out of date");
+static_assert(Four::ANTIALIAS_PARAM == four::PANEL_ANTIALIAS, "panel.h out of date");
+static_assert(Four::PARAMS_LEN == four::PANEL_PARAMS_LEN, "panel.h out of date");
+
 #include "layout.h"
 
 struct AlgoDisplay : Widget {
@@ -261,7 +439,7 @@ struct AlgoDisplay : Widget {
         // Text
         int algo = 0;
         if ( module )
-            algo = (int)module->params[Four::ALGO_PARAM].getValue();
+            algo = module->activeAlgorithm;
 
         const char* text = four::algorithmStrings[algo];
         nvgFontSize(args.vg, 14);
@@ -280,6 +458,7 @@ struct AlgoDisplay : Widget {
             int algo = (int)module->params[Four::ALGO_PARAM].getValue();
             algo = ( algo + 1 ) % 11;
             module->params[Four::ALGO_PARAM].setValue( (float)algo );
+            module->publishSettings();
             e.consume(this);
         }
         else if ( e.action == GLFW_PRESS && e.button == GLFW_MOUSE_BUTTON_RIGHT )
@@ -290,7 +469,10 @@ struct AlgoDisplay : Widget {
             {
                 int algoIdx = i;
                 menu->addChild(createMenuItem(four::algorithmStrings[i], "",
-                    [=]() { module->params[Four::ALGO_PARAM].setValue((float)algoIdx); }));
+                    [=]() {
+                        module->params[Four::ALGO_PARAM].setValue((float)algoIdx);
+                        module->publishSettings();
+                    }));
             }
             e.consume(this);
         }
@@ -323,6 +505,7 @@ struct FoldTypeDisplay : Widget {
         const int ids[] = { Four::OP1_FOLD_TYPE_PARAM, Four::OP2_FOLD_TYPE_PARAM,
                             Four::OP3_FOLD_TYPE_PARAM, Four::OP4_FOLD_TYPE_PARAM };
         module->params[ids[opIndex]].setValue((float)v);
+        module->publishSettings();
     }
 
     void drawLayer(const DrawArgs& args, int layer) override {
@@ -482,6 +665,8 @@ struct PanelLabels : Widget {
         float jackOff = mm2px(4.7f);   // jack radius + 1.5mm gap
         nvgText(args.vg, mm2px(VOCT_JACK_X) - jackOff, mm2px(VOCT_JACK_Y), "V/Oct", nullptr);
         nvgText(args.vg, mm2px(XM_KNOB_X) - knobOff, mm2px(XM_KNOB_Y), "XMod", nullptr);
+        nvgText(args.vg, mm2px(ALGO_CV_JACK_X) - jackOff, mm2px(ALGO_CV_JACK_Y), "Algo", nullptr);
+        nvgText(args.vg, mm2px(GATE_JACK_X) - jackOff, mm2px(GATE_JACK_Y), "Gate", nullptr);
         // Ext PM label: positioned left of jack
         nvgText(args.vg, mm2px(FM_CV_JACK_X) - jackOff, mm2px(FM_CV_JACK_Y), "Ext PM", nullptr);
 
@@ -548,6 +733,8 @@ struct FourWidget : ModuleWidget {
         addParam(createParamCentered<RoundSmallBlackKnob>(mm2px(Vec(XM_KNOB_X, XM_KNOB_Y)), module, Four::XM_PARAM));
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(XM_CV_JACK_X, XM_CV_JACK_Y)), module, Four::XM_CV_INPUT));
         addParam(createParamCentered<Trimpot>(mm2px(Vec(XM_CV_ATTEN_X, XM_CV_ATTEN_Y)), module, Four::XM_CV_ATTEN_PARAM));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(ALGO_CV_JACK_X, ALGO_CV_JACK_Y)), module, Four::ALGO_CV_INPUT));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(GATE_JACK_X, GATE_JACK_Y)), module, Four::GATE_INPUT));
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(FM_CV_JACK_X, FM_CV_JACK_Y)), module, Four::EXT_PM_CV_INPUT));
         addParam(createParamCentered<Trimpot>(mm2px(Vec(FM_CV_ATTEN_X, FM_CV_ATTEN_Y)), module, Four::EXT_PM_CV_ATTEN_PARAM));
 
@@ -632,6 +819,40 @@ struct FourWidget : ModuleWidget {
             addChild(ftd);
         }
     }
+
+    void appendContextMenu(Menu* menu) override {
+        Four* module = getModule<Four>();
+
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createSubmenuItem("Modulation", "", [=](Menu* menu) {
+            menu->addChild(createMenuLabel("LFO and envelope per operator (Gate restarts envelopes)"));
+            for ( int i = 0; i < 4; i++ )
+            {
+                int op = i;
+                menu->addChild(createSubmenuItem("Op " + std::to_string(i + 1), "", [=](Menu* menu) {
+                    menu->addChild(new ParamSlider(module->getParamQuantity(Four::OP1_LFO_RATE_PARAM + op)));
+                    menu->addChild(new ParamSlider(module->getParamQuantity(Four::OP1_ENV_ATTACK_PARAM + op)));
+                    menu->addChild(new ParamSlider(module->getParamQuantity(Four::OP1_ENV_DECAY_PARAM + op)));
+                    menu->addChild(new MenuSeparator);
+                    for ( int src = 0; src < four::NUM_MOD_SOURCES; src++ )
+                        for ( int t = 0; t < four::NUM_MOD_TARGETS; t++ )
+                            menu->addChild(new ParamSlider(module->getParamQuantity(Four::modAmountParam(src, t, op))));
+                }));
+            }
+        }));
+        menu->addChild(createIndexSubmenuItem("Anti-aliasing",
+            {"2x oversampling", "2x + alias guard", "1x + alias guard"},
+            [=]() { return (size_t)module->params[Four::ANTIALIAS_PARAM].getValue(); },
+            [=](size_t i) {
+                module->params[Four::ANTIALIAS_PARAM].setValue((float)i);
+                module->publishSettings();
+            }));
+        menu->addChild(createSubmenuItem("Developer", "", [=](Menu* menu) {
+            menu->addChild(createBoolMenuItem("Capture inputs to file", "",
+                [=]() { return module->capture.isRecording(); },
+                [=](bool on) { module->setCapture(on); }));
+        }));
+    }
 };
 
 Model* modelFour = createModel<Four, FourWidget>("FourMM");
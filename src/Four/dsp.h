@@ -18,13 +18,23 @@ inline void flush_denormal( float& x )
         x = 0.0f;
 }
 
-// DC blocker: 1-pole highpass filter at ~20Hz
+// DC blocker corner: that of the original fixed pole R = 0.999 at 48kHz
+static constexpr float DC_BLOCKER_HZ = 7.64f;
+
+// DC blocker: 1-pole highpass filter at DC_BLOCKER_HZ
 // state: previous input sample, returns output
 struct DCBlocker
 {
     float prevInput = 0.0f;
     float prevOutput = 0.0f;
-    float R = 0.999f;  // Pole for ~20Hz at 48kHz
+    float R = 0.999f;  // Pole, for DC_BLOCKER_HZ at 48kHz until setCutoff
+
+    // Pole for a corner frequency at a sample rate, so the corner stays put
+    // when the rate changes
+    void setCutoff( float hz, float sampleRate )
+    {
+        R = expf( -TWO_PI * hz / sampleRate );
+    }
 
     float process( float input )
     {
@@ -267,6 +277,60 @@ inline float sum_carriers(
     return mix;
 }
 
+// Algorithm routing precompiled to 0/1 weights, so the algorithm can change
+// every sample (algorithm CV) with no per-switch setup and no branches per route.
+struct AlgorithmRouting
+{
+    float mod[4][4];    // mod[src][dst]: weight of src in dst's phase modulation
+    float carrier[4];   // carrier[op]: weight of op in the output mix
+};
+
+struct RoutingTable
+{
+    AlgorithmRouting algo[11];
+
+    RoutingTable()
+    {
+        for ( int a = 0; a < 11; a++ )
+        {
+            for ( int src = 0; src < 4; src++ )
+            {
+                for ( int dst = 0; dst < 4; dst++ )
+                    algo[a].mod[src][dst] = algorithms[a].mod[src][dst] ? 1.0f : 0.0f;
+                algo[a].carrier[src] = algorithms[a].carrier[src] ? 1.0f : 0.0f;
+            }
+        }
+    }
+};
+
+static const RoutingTable routingTable;
+
+// Branchless equivalent of gather_modulation
+inline float gather_modulation_routed(
+    int target,
+    const float opOut[4],
+    const float level[4],
+    float modMaster,
+    const AlgorithmRouting& routing )
+{
+    float pm = 0.0f;
+    for ( int src = 0; src < 4; ++src )
+        pm += opOut[src] * level[src] * modMaster * routing.mod[src][target];
+    return pm;
+}
+
+// Branchless equivalent of sum_carriers
+inline float sum_carriers_routed(
+    const float opOut[4],
+    const float level[4],
+    const AlgorithmRouting& routing )
+{
+    float mix = 0.0f;
+    for ( int op = 0; op < 4; ++op )
+        mix += opOut[op] * level[op] * routing.carrier[op];
+    return mix;
+}
+
 // Calculate feedback contribution from previous output
 // prev_output: previous sample output, amount: 0.0-1.0
 // Returns phase modulation amount (bounded)
@@ -2,6 +2,8 @@
 #define FOURMM_ENGINE_H
 
 #include "dsp.h"
+#include "modulation.h"
+#include "../events.h"
 #include <algorithm>
 
 namespace four {
@@ -12,18 +14,46 @@ struct OperatorState
     float prevOutput = 0.f;
 };
 
+// Control-rate modulation offsets for level, warp, fold and feedback,
+// ramped linearly from one control tick to the next (see engine_set_modulation)
+struct ModRamp
+{
+    float value[NUM_MOD_TARGETS][4] = {};
+    float target[NUM_MOD_TARGETS][4] = {};
+    float step[NUM_MOD_TARGETS][4] = {};
+    int remaining = 0;          // samples left in the current ramp
+    bool active = false;        // false when all values and targets are zero
+};
+
+// Samples between alias guard updates
+static const int ALIAS_GUARD_DIVISION = 32;
+
+// Per-operator scale on incoming modulation depth, recomputed every
+// ALIAS_GUARD_DIVISION samples and ramped linearly in between
+// (see engine_alias_guard_tick)
+struct AliasGuard
+{
+    float scale[4] = { 1.f, 1.f, 1.f, 1.f };   // 0.0-1.0, 1 = unguarded
+    float step[4] = {};
+    int counter = 0;            // samples until the next update, 0 = idle
+};
+
 struct EngineState
 {
     OperatorState ops[4];
     DCBlocker dcBlocker;
+    ModRamp mod;
+    AliasGuard guard;
 };
 
 struct EngineParams
 {
-    int algorithm = 0;          // 0-10
+    int algorithm = 0;          // 0-10, may change every sample
     float modMaster = 0.f;     // 0.0-1.0 global modulation depth
     float extPmDepth = 0.f;    // 0.0-1.0 external PM depth
     float globalVCA = 1.f;     // 0.0-1.0
+    int oversample = 2;         // 1 or 2
+    bool aliasGuard = false;    // limit modulation depth to keep sidebands below Nyquist
 
     float baseFreq = 261.63f;  // Hz, from V/OCT + global fine tune
 
@@ -38,37 +68,224 @@ struct EngineParams
     int opFoldType[4] = {};     // 0=sym, 1=asym, 2=soft
 };
 
-// Process one sample. Internally runs 2x oversampled.
-// sampleTime: 1.0 / sampleRate (the VCV sample period, NOT oversampled)
-// extPm: external phase modulation amount (audio rate, typically +/- 5V)
-// Returns output sample in range roughly [-1, 1] before VCA.
-inline float engine_process( EngineState& state, const EngineParams& params, float sampleTime, float extPm = 0.f )
+// Anti-aliasing choices offered by the module
+enum AntialiasMode
+{
+    ANTIALIAS_2X = 0,           // fixed 2x oversampling
+    ANTIALIAS_2X_GUARD,         // 2x with the alias guard
+    ANTIALIAS_1X_GUARD,         // 1x with the alias guard
+    NUM_ANTIALIAS_MODES
+};
+
+inline void engine_set_antialias( EngineParams& params, int mode )
+{
+    params.oversample = ( mode == ANTIALIAS_1X_GUARD ) ? 1 : 2;
+    params.aliasGuard = mode == ANTIALIAS_2X_GUARD || mode == ANTIALIAS_1X_GUARD;
+}
+
+// Parameter ids for timestamped events (see apply_param_event).
+// Per-operator ids are the base id plus the operator index (0-3).
+enum EngineParamId
+{
+    PARAM_ALGORITHM = 0,
+    PARAM_MOD_MASTER,
+    PARAM_EXT_PM_DEPTH,
+    PARAM_GLOBAL_VCA,
+    PARAM_BASE_FREQ,
+    PARAM_OVERSAMPLE,
+    PARAM_ALIAS_GUARD,
+    PARAM_OP_COARSE = 8,
+    PARAM_OP_FINE = 12,
+    PARAM_OP_LEVEL = 16,
+    PARAM_OP_WARP = 20,
+    PARAM_OP_FOLD = 24,
+    PARAM_OP_FEEDBACK = 28,
+    PARAM_OP_FREQ_MODE = 32,
+    PARAM_OP_FOLD_TYPE = 36,
+    PARAM_COUNT = 40
+};
+
+// Apply one parameter change.
+// Returns true if operator frequencies need to be recomputed.
+inline bool apply_param_event( EngineParams& params, int id, float value )
+{
+    if ( id >= PARAM_OP_COARSE && id < PARAM_COUNT )
+    {
+        int op = id & 3;
+        switch ( id & ~3 )
+        {
+        case PARAM_OP_COARSE:    params.opCoarse[op] = value; return true;
+        case PARAM_OP_FINE:      params.opFine[op] = value; return true;
+        case PARAM_OP_LEVEL:     params.opLevel[op] = value; return false;
+        case PARAM_OP_WARP:      params.opWarp[op] = value; return false;
+        case PARAM_OP_FOLD:      params.opFold[op] = value; return false;
+        case PARAM_OP_FEEDBACK:  params.opFeedback[op] = value; return false;
+        case PARAM_OP_FREQ_MODE: params.opFreqMode[op] = (int)value; return true;
+        case PARAM_OP_FOLD_TYPE: params.opFoldType[op] = (int)value; return false;
+        }
+        return false;
+    }
+
+    switch ( id )
+    {
+    case PARAM_ALGORITHM:    params.algorithm = std::max( 0, std::min( 10, (int)value ) ); break;
+    case PARAM_MOD_MASTER:   params.modMaster = value; break;
+    case PARAM_EXT_PM_DEPTH: params.extPmDepth = value; break;
+    case PARAM_GLOBAL_VCA:   params.globalVCA = value; break;
+    case PARAM_BASE_FREQ:    params.baseFreq = value; return true;
+    case PARAM_OVERSAMPLE:   params.oversample = ( (int)value == 1 ) ? 1 : 2; break;
+    case PARAM_ALIAS_GUARD:  params.aliasGuard = value > 0.5f; break;
+    }
+    return false;
+}
+
+// Current value of one parameter (inverse of apply_param_event).
+// Unused ids read as 0.
+inline float engine_param_value( const EngineParams& params, int id )
+{
+    if ( id >= PARAM_OP_COARSE && id < PARAM_COUNT )
+    {
+        int op = id & 3;
+        switch ( id & ~3 )
+        {
+        case PARAM_OP_COARSE:    return params.opCoarse[op];
+        case PARAM_OP_FINE:      return params.opFine[op];
+        case PARAM_OP_LEVEL:     return params.opLevel[op];
+        case PARAM_OP_WARP:      return params.opWarp[op];
+        case PARAM_OP_FOLD:      return params.opFold[op];
+        case PARAM_OP_FEEDBACK:  return params.opFeedback[op];
+        case PARAM_OP_FREQ_MODE: return (float)params.opFreqMode[op];
+        case PARAM_OP_FOLD_TYPE: return (float)params.opFoldType[op];
+        }
+        return 0.f;
+    }
+
+    switch ( id )
+    {
+    case PARAM_ALGORITHM:    return (float)params.algorithm;
+    case PARAM_MOD_MASTER:   return params.modMaster;
+    case PARAM_EXT_PM_DEPTH: return params.extPmDepth;
+    case PARAM_GLOBAL_VCA:   return params.globalVCA;
+    case PARAM_BASE_FREQ:    return params.baseFreq;
+    case PARAM_OVERSAMPLE:   return (float)params.oversample;
+    case PARAM_ALIAS_GUARD:  return params.aliasGuard ? 1.f : 0.f;
+    }
+    return 0.f;
+}
+
+// Capture frame layout (see capture.h): one channel per EngineParamId,
+// followed by the audio-rate external PM input.
+static const int CAPTURE_CHANNELS = PARAM_COUNT + 1;
+static const int CAPTURE_EXT_PM = PARAM_COUNT;
+
+inline void engine_capture_frame( const EngineParams& params, float extPm, float frame[CAPTURE_CHANNELS] )
+{
+    for ( int id = 0; id < PARAM_COUNT; id++ )
+        frame[id] = engine_param_value( params, id );
+    frame[CAPTURE_EXT_PM] = extPm;
+}
+
+// Operator frequencies in Hz, derived from base frequency, coarse, fine and mode
+inline void engine_calc_frequencies( const EngineParams& params, float freq[4] )
+{
+    for ( int op = 0; op < 4; op++ )
+    {
+        if ( params.opFreqMode[op] == 0 )
+            freq[op] = calc_frequency_ratio( params.baseFreq, params.opCoarse[op], params.opFine[op] );
+        else
+            freq[op] = calc_frequency_fixed( params.opCoarse[op], params.opFine[op] );
+    }
+}
+
+// Carson's rule estimate of each operator's modulation bandwidth:
+// an operator at fc, phase-modulated by operators at fm_i with peak index
+// beta_i = 2pi * level_i * modMaster, has significant sidebands up to about
+// fc + sum( beta_i * fm_i ) + max( fm_i ).
+// scale[op] is the factor on op's incoming modulation depth that keeps that
+// edge below nyquist: 1 when it already fits, 0 when even the carrier and
+// modulator frequencies alone reach it. Feedback and external PM are not counted.
+inline void alias_guard_scales( const EngineParams& params, const float freq[4], float nyquist, float scale[4] )
+{
+    const AlgorithmRouting& routing = routingTable.algo[params.algorithm];
+
+    for ( int dst = 0; dst < 4; dst++ )
+    {
+        float deviation = 0.f;
+        float maxFm = 0.f;
+        for ( int src = 0; src < 4; src++ )
+        {
+            float beta = TWO_PI * params.opLevel[src] * params.modMaster * routing.mod[src][dst];
+            float fm = fabsf( freq[src] );
+            deviation += beta * fm;
+            maxFm = fmaxf( maxFm, beta > 0.f ? fm : 0.f );
+        }
+
+        float headroom = nyquist - fabsf( freq[dst] ) - maxFm;
+        scale[dst] = ( deviation > headroom ) ? fmaxf( headroom, 0.f ) / deviation : 1.f;
+    }
+}
+
+// Advance the alias guard by one sample: recompute the target scales every
+// ALIAS_GUARD_DIVISION samples and ramp toward them. With the guard off the
+// scales snap back to 1.
+// sampleTime: host sample period. The limit is the host Nyquist even when
+// oversampling, since downsample_2x is only a two-tap average and lets
+// sidebands between the host and oversampled Nyquist fold back.
+inline void engine_alias_guard_tick( AliasGuard& g, const EngineParams& params, const float freq[4], float sampleTime )
+{
+    if ( !params.aliasGuard )
+    {
+        if ( g.counter != 0 )
+        {
+            for ( int op = 0; op < 4; op++ )
+            {
+                g.scale[op] = 1.f;
+                g.step[op] = 0.f;
+            }
+            g.counter = 0;
+        }
+        return;
+    }
+
+    if ( --g.counter <= 0 )
+    {
+        float target[4];
+        alias_guard_scales( params, freq, 0.5f / sampleTime, target );
+        for ( int op = 0; op < 4; op++ )
+            g.step[op] = ( target[op] - g.scale[op] ) * ( 1.f / ALIAS_GUARD_DIVISION );
+        g.counter = ALIAS_GUARD_DIVISION;
+    }
+
+    for ( int op = 0; op < 4; op++ )
+        g.scale[op] += g.step[op];
+}
+
+// Process one sample with precomputed operator frequencies (see engine_calc_frequencies).
+inline float engine_process_freq( EngineState& state, const EngineParams& params, const float freq[4],
+                                  float sampleTime, float extPm = 0.f )
 {
-    const float osTime = sampleTime * 0.5f;
-    const Algorithm& algo = algorithms[params.algorithm];
+    const int passes = ( params.oversample == 1 ) ? 1 : 2;
+    const float osTime = sampleTime / (float)passes;
+    const AlgorithmRouting& routing = routingTable.algo[params.algorithm];
     float result[2];
 
-    for ( int pass = 0; pass < 2; pass++ )
+    engine_alias_guard_tick( state.guard, params, freq, sampleTime );
+
+    for ( int pass = 0; pass < passes; pass++ )
     {
         float opOut[4] = {};
 
         // Compute operators in fixed order: 4, 3, 2, 1 (index 3, 2, 1, 0)
         for ( int op = 3; op >= 0; op-- )
         {
-            // Compute operator frequency
-            float freq;
-            if ( params.opFreqMode[op] == 0 )
-                freq = calc_frequency_ratio( params.baseFreq, params.opCoarse[op], params.opFine[op] );
-            else
-                freq = calc_frequency_fixed( params.opCoarse[op], params.opFine[op] );
-
-            float inc = freq * osTime;
+            float inc = freq[op] * osTime;
 
             // Advance phase (clean, without modulation)
             phase_advance( state.ops[op].phase, inc );
 
-            // Gather phase modulation from higher operators
-            float pm = gather_modulation( op, opOut, params.opLevel, params.modMaster, algo );
+            // Gather phase modulation from higher operators, limited by the alias guard
+            float pm = gather_modulation_routed( op, opOut, params.opLevel, params.modMaster, routing )
+                     * state.guard.scale[op];
 
             // Add self-feedback
             pm += calc_feedback( state.ops[op].prevOutput, params.opFeedback[op] );
@@ -88,10 +305,10 @@ inline float engine_process( EngineState& state, const EngineParams& params, flo
             state.ops[op].prevOutput = out;
         }
 
-        result[pass] = sum_carriers( opOut, params.opLevel, algo );
+        result[pass] = sum_carriers_routed( opOut, params.opLevel, routing );
     }
 
-    float out = downsample_2x( result[0], result[1] );
+    float out = ( passes == 2 ) ? downsample_2x( result[0], result[1] ) : result[0];
     out = state.dcBlocker.process( out );
 
     // External PM: treat synth output as a sine wave, apply phase modulation
@@ -109,6 +326,104 @@ inline float engine_process( EngineState& state, const EngineParams& params, flo
     return out;
 }
 
+// Sample-rate dependent state (the DC blocker pole). Call when the rate changes.
+inline void engine_set_sample_rate( EngineState& state, float sampleRate )
+{
+    state.dcBlocker.setCutoff( DC_BLOCKER_HZ, sampleRate );
+}
+
+// Start a ramp from the current modulation offsets to new ones over `frames` samples
+inline void engine_set_modulation( EngineState& state, const float offset[NUM_MOD_TARGETS][4], int frames )
+{
+    ModRamp& r = state.mod;
+    float inv = 1.f / (float)std::max( frames, 1 );
+    bool active = false;
+    for ( int t = 0; t < NUM_MOD_TARGETS; t++ )
+    {
+        for ( int op = 0; op < 4; op++ )
+        {
+            r.target[t][op] = offset[t][op];
+            r.step[t][op] = ( offset[t][op] - r.value[t][op] ) * inv;
+            active = active || offset[t][op] != 0.f || r.value[t][op] != 0.f;
+        }
+    }
+    r.remaining = std::max( frames, 1 );
+    r.active = active;
+}
+
+// Add the current modulation offsets to params (clamped to 0-1), then
+// advance the ramp by one sample
+inline void engine_apply_modulation( ModRamp& r, EngineParams& params )
+{
+    float* fields[NUM_MOD_TARGETS] = { params.opLevel, params.opWarp, params.opFold, params.opFeedback };
+    for ( int t = 0; t < NUM_MOD_TARGETS; t++ )
+        for ( int op = 0; op < 4; op++ )
+            fields[t][op] = fminf( fmaxf( fields[t][op] + r.value[t][op], 0.f ), 1.f );
+
+    if ( r.remaining > 0 )
+    {
+        bool last = --r.remaining == 0;
+        for ( int t = 0; t < NUM_MOD_TARGETS; t++ )
+            for ( int op = 0; op < 4; op++ )
+                r.value[t][op] = last ? r.target[t][op] : r.value[t][op] + r.step[t][op];
+    }
+}
+
+// Process one sample with precomputed frequencies, applying the modulation ramp if active
+inline float engine_process_modulated( EngineState& state, const EngineParams& params, const float freq[4],
+                                       float sampleTime, float extPm )
+{
+    if ( !state.mod.active )
+        return engine_process_freq( state, params, freq, sampleTime, extPm );
+
+    EngineParams modulated = params;
+    engine_apply_modulation( state.mod, modulated );
+    return engine_process_freq( state, modulated, freq, sampleTime, extPm );
+}
+
+// Process one sample. Internally runs 2x oversampled unless params.oversample is 1.
+// sampleTime: 1.0 / sampleRate (the VCV sample period, NOT oversampled)
+// extPm: external phase modulation amount (audio rate, typically +/- 5V)
+// Built-in modulation (state.mod) is added to level, warp, fold and feedback.
+// Returns output sample in range roughly [-1, 1] before VCA.
+inline float engine_process( EngineState& state, const EngineParams& params, float sampleTime, float extPm = 0.f )
+{
+    float freq[4];
+    engine_calc_frequencies( params, freq );
+    return engine_process_modulated( state, params, freq, sampleTime, extPm );
+}
+
+// Render a block of samples, applying queued parameter events at their exact
+// sample offsets. Operator frequencies are only recomputed when an event
+// changes them. Applied events persist in params.
+// extPm: per-sample external PM, or nullptr for none
+template <int Capacity>
+inline void engine_process_block( EngineState& state, EngineParams& params, float sampleTime,
+                                  const float* extPm, float* out, int frames,
+                                  wintoid::ParamEventQueue<Capacity>& events )
+{
+    float freq[4];
+    engine_calc_frequencies( params, freq );
+    bool freqDirty = false;
+
+    wintoid::render_with_events( events, frames,
+        [&]( const wintoid::ParamEvent& e )
+        {
+            if ( apply_param_event( params, e.paramId, e.value ) )
+                freqDirty = true;
+        },
+        [&]( int start, int count )
+        {
+            if ( freqDirty )
+            {
+                engine_calc_frequencies( params, freq );
+                freqDirty = false;
+            }
+            for ( int i = start; i < start + count; i++ )
+                out[i] = engine_process_modulated( state, params, freq, sampleTime, extPm ? extPm[i] : 0.f );
+        } );
+}
+
 } // namespace four
 
 #endif // FOURMM_ENGINE_H
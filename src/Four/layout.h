@@ -18,6 +18,8 @@ constexpr float VOCT_JACK_X = 20.0f;
 constexpr float VOCT_JACK_Y = 26.0f;
 constexpr float FINE_TUNE_KNOB_X = 66.0f;
 constexpr float FINE_TUNE_KNOB_Y = 26.0f;
+constexpr float GATE_JACK_X = 88.0f;
+constexpr float GATE_JACK_Y = 26.0f;
 constexpr float VCA_KNOB_X = 105.1f;
 constexpr float VCA_KNOB_Y = 26.0f;
 constexpr float MAIN_OUTPUT_X = 114.1f;
@@ -28,6 +30,8 @@ constexpr float XM_CV_JACK_X = 29.0f;
 constexpr float XM_CV_JACK_Y = 36.0f;
 constexpr float XM_CV_ATTEN_X = 37.0f;
 constexpr float XM_CV_ATTEN_Y = 36.0f;
+constexpr float ALGO_CV_JACK_X = 66.0f;
+constexpr float ALGO_CV_JACK_Y = 36.0f;
 constexpr float FM_CV_JACK_X = 105.1f;
 constexpr float FM_CV_JACK_Y = 36.0f;
 constexpr float FM_CV_ATTEN_X = 114.1f;
@@ -0,0 +1,102 @@
+#ifndef FOURMM_MODULATION_H
+#define FOURMM_MODULATION_H
+
+// Built-in modulation sources for Four: one LFO and one AD envelope per
+// operator, routed to level, warp, fold and feedback through an amount matrix.
+// Evaluated at control rate; the engine ramps the results per sample
+// (see ModRamp in engine.h).
+// No VCV Rack API dependencies — testable on desktop.
+//
+// Every per-operator quantity is a 4-lane array and each loop below works
+// lane by lane without branches, so the compiler can map the four operators
+// onto one SSE/NEON vector.
+
+#include "dsp.h"
+
+namespace four {
+
+enum ModSource
+{
+    MOD_SRC_LFO = 0,
+    MOD_SRC_ENV,
+    NUM_MOD_SOURCES
+};
+
+enum ModTarget
+{
+    MOD_LEVEL = 0,
+    MOD_WARP,
+    MOD_FOLD,
+    MOD_FEEDBACK,
+    NUM_MOD_TARGETS
+};
+
+// Samples per control-rate tick
+static const int MOD_CONTROL_DIVISION = 32;
+
+struct ModParams
+{
+    float lfoRate[4] = { 1.f, 1.f, 1.f, 1.f };             // Hz
+    float attack[4] = { 0.01f, 0.01f, 0.01f, 0.01f };      // seconds
+    float decay[4] = { 0.5f, 0.5f, 0.5f, 0.5f };           // seconds
+    float amount[NUM_MOD_SOURCES][NUM_MOD_TARGETS][4] = {}; // -1.0-1.0
+};
+
+struct ModState
+{
+    float lfoPhase[4] = {};
+    float env[4] = {};
+    float attacking[4] = {};    // 1 while the envelope rises, 0 while it decays
+};
+
+// True if any routing amount is non-zero
+inline bool mod_params_active( const ModParams& params )
+{
+    for ( int src = 0; src < NUM_MOD_SOURCES; src++ )
+        for ( int t = 0; t < NUM_MOD_TARGETS; t++ )
+            for ( int op = 0; op < 4; op++ )
+                if ( params.amount[src][t][op] != 0.f )
+                    return true;
+    return false;
+}
+
+// Advance all sources by dt seconds (one control tick).
+// trigger restarts every envelope's attack from its current level.
+// lfo: bipolar sine, -1.0-1.0; env: unipolar, 0.0-1.0
+inline void mod_sources_tick( ModState& state, const ModParams& params, float dt, bool trigger,
+                              float lfo[4], float env[4] )
+{
+    float retrigger = trigger ? 1.f : 0.f;
+
+    for ( int op = 0; op < 4; op++ )
+    {
+        // LFO
+        float phase = state.lfoPhase[op] + params.lfoRate[op] * dt;
+        phase -= floorf( phase );
+        state.lfoPhase[op] = phase;
+        lfo[op] = oscillator_sine( phase );
+
+        // Envelope: linear attack to 1, linear decay to 0
+        float attacking = fmaxf( state.attacking[op], retrigger );
+        float up = fminf( state.env[op] + dt / params.attack[op], 1.f );
+        float down = fmaxf( state.env[op] - dt / params.decay[op], 0.f );
+        float e = attacking * up + ( 1.f - attacking ) * down;
+        state.env[op] = e;
+        state.attacking[op] = attacking * ( up < 1.f ? 1.f : 0.f );
+        env[op] = e;
+    }
+}
+
+// Routing matrix: offset[target][op] = sum over sources of amount * source
+inline void mod_matrix( const ModParams& params, const float lfo[4], const float env[4],
+                        float offset[NUM_MOD_TARGETS][4] )
+{
+    for ( int t = 0; t < NUM_MOD_TARGETS; t++ )
+        for ( int op = 0; op < 4; op++ )
+            offset[t][op] = params.amount[MOD_SRC_LFO][t][op] * lfo[op]
+                          + params.amount[MOD_SRC_ENV][t][op] * env[op];
+}
+
+} // namespace four
+
+#endif // FOURMM_MODULATION_H
@@ -0,0 +1,143 @@
+#ifndef FOURMM_PANEL_H
+#define FOURMM_PANEL_H
+
+// Four's panel parameter ids (as saved in Rack patches) and the mapping from
+// panel values to engine params. Four.cpp static_asserts that its ParamId
+// enum matches and maps its values through the same helpers, so saved
+// patches render offline (with no cables patched) as the module plays them.
+// No VCV Rack API dependencies — testable on desktop.
+
+#include "engine.h"
+
+namespace four {
+
+// Per-operator ids are the base id plus the operator index (0-3)
+enum PanelParamId
+{
+    PANEL_ALGO = 0,
+    PANEL_XM,
+    PANEL_FINE_TUNE,
+    PANEL_VCA,
+    PANEL_OP_COARSE = 4,
+    PANEL_OP_FINE = 8,
+    PANEL_OP_LEVEL = 12,
+    PANEL_OP_WARP = 16,
+    PANEL_OP_FOLD = 20,
+    PANEL_OP_FB = 24,
+    PANEL_XM_CV_ATTEN = 28,
+    PANEL_EXT_PM_CV_ATTEN,
+    PANEL_OP_LEVEL_CV_ATTEN = 30,
+    PANEL_OP_WARP_CV_ATTEN = 34,
+    PANEL_OP_FOLD_CV_ATTEN = 38,
+    PANEL_OP_FB_CV_ATTEN = 42,
+    PANEL_OP_FREQ_MODE = 46,
+    PANEL_OP_FOLD_TYPE = 50,
+    PANEL_OP_LFO_RATE = 54,
+    PANEL_OP_ENV_ATTACK = 58,
+    PANEL_OP_ENV_DECAY = 62,
+    PANEL_OP_MOD_AMOUNT = 66,   // + ( source * NUM_MOD_TARGETS + target ) * 4 + op
+    PANEL_ANTIALIAS = 98,
+    PANEL_PARAMS_LEN
+};
+
+// configParam defaults (for params missing from a patch)
+inline void panel_defaults( float values[PANEL_PARAMS_LEN] )
+{
+    for ( int id = 0; id < PANEL_PARAMS_LEN; id++ )
+        values[id] = 0.f;
+    values[PANEL_XM] = 1.f;
+    values[PANEL_VCA] = 1.f;
+    values[PANEL_OP_LEVEL] = 1.f;
+    for ( int op = 0; op < 4; op++ )
+    {
+        values[PANEL_OP_COARSE + op] = 3.f;
+        values[PANEL_OP_ENV_ATTACK + op] = log2f( 0.01f );
+        values[PANEL_OP_ENV_DECAY + op] = log2f( 0.5f );
+    }
+}
+
+// --- Panel value -> engine value mapping ---
+// Shared by Four::process and panel_engine_params, so offline renders follow
+// the module. CV arguments are in volts (0 when unpatched).
+
+// Algorithm knob (0-10) plus 1V per step
+inline int panel_algorithm( float knob, float cv )
+{
+    return std::max( 0, std::min( 10, (int)knob + (int)roundf( cv ) ) );
+}
+
+// Coarse: ratio index in ratio mode, Hz param in fixed mode
+inline float panel_coarse( int freqMode, float coarse )
+{
+    return ( freqMode == 0 ) ? coarse_ratio_from_index( (int)roundf( coarse ) )
+                             : coarse_fixed_from_param( coarse );
+}
+
+// Fine tune: cents -> frequency multiplier
+inline float panel_fine_mult( float cents )
+{
+    return exp2f( cents / 1200.f );
+}
+
+// 0-1 knob plus attenuated CV (10V = full range): mod, level, warp, fold, feedback
+inline float panel_unipolar( float knob, float cv, float atten )
+{
+    return std::max( 0.f, std::min( 1.f, knob + cv * atten / 10.f ) );
+}
+
+// Ext PM depth: attenuated CV only (no depth knob)
+inline float panel_ext_pm_depth( float cv, float atten )
+{
+    return std::max( 0.f, std::min( 1.f, cv * atten ) );
+}
+
+// Engine params for the panel settings, V/Oct at 0V and no CV
+inline EngineParams panel_engine_params( const float values[PANEL_PARAMS_LEN] )
+{
+    EngineParams ep;
+    ep.algorithm = panel_algorithm( values[PANEL_ALGO], 0.f );
+    ep.modMaster = panel_unipolar( values[PANEL_XM], 0.f, 0.f );
+    ep.extPmDepth = panel_ext_pm_depth( 0.f, values[PANEL_EXT_PM_CV_ATTEN] );
+    ep.globalVCA = values[PANEL_VCA];
+    ep.baseFreq = voct_to_freq( 0.f ) * panel_fine_mult( values[PANEL_FINE_TUNE] );
+    engine_set_antialias( ep, (int)values[PANEL_ANTIALIAS] );
+
+    for ( int op = 0; op < 4; op++ )
+    {
+        int freqMode = (int)values[PANEL_OP_FREQ_MODE + op];
+        ep.opFreqMode[op] = freqMode;
+        ep.opFoldType[op] = (int)values[PANEL_OP_FOLD_TYPE + op];
+        ep.opCoarse[op] = panel_coarse( freqMode, values[PANEL_OP_COARSE + op] );
+        ep.opFine[op] = panel_fine_mult( values[PANEL_OP_FINE + op] );
+        ep.opLevel[op] = panel_unipolar( values[PANEL_OP_LEVEL + op], 0.f, 0.f );
+        ep.opWarp[op] = panel_unipolar( values[PANEL_OP_WARP + op], 0.f, 0.f );
+        ep.opFold[op] = panel_unipolar( values[PANEL_OP_FOLD + op], 0.f, 0.f );
+        ep.opFeedback[op] = panel_unipolar( values[PANEL_OP_FB + op], 0.f, 0.f );
+    }
+    return ep;
+}
+
+// LFO rate and envelope times of one operator, from their log2 params
+inline void panel_mod_times( ModParams& mp, int op, float lfoRate, float attack, float decay )
+{
+    mp.lfoRate[op] = exp2f( lfoRate );
+    mp.attack[op] = exp2f( attack );
+    mp.decay[op] = exp2f( decay );
+}
+
+// Built-in modulation settings (see modulation.h)
+inline void panel_mod_params( const float values[PANEL_PARAMS_LEN], ModParams& mp )
+{
+    for ( int op = 0; op < 4; op++ )
+    {
+        panel_mod_times( mp, op, values[PANEL_OP_LFO_RATE + op], values[PANEL_OP_ENV_ATTACK + op],
+                         values[PANEL_OP_ENV_DECAY + op] );
+        for ( int src = 0; src < NUM_MOD_SOURCES; src++ )
+            for ( int t = 0; t < NUM_MOD_TARGETS; t++ )
+                mp.amount[src][t][op] = values[PANEL_OP_MOD_AMOUNT + ( src * NUM_MOD_TARGETS + t ) * 4 + op];
+    }
+}
+
+} // namespace four
+
+#endif // FOURMM_PANEL_H
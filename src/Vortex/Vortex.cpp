@@ -1,5 +1,8 @@
 #include "../plugin.hpp"
-#include "dsp.h"
+#include "engine.h"
+#include "panel.h"
+#include "../capture.h"
+#include "../snapshot.h"
 
 struct CutoffParamQuantity : ParamQuantity {
     std::string getDisplayValueString() override {
@@ -10,6 +13,20 @@ struct CutoffParamQuantity : ParamQuantity {
     }
 };
 
+struct MorphParamQuantity : ParamQuantity {
+    std::string getDisplayValueString() override {
+        static const char* names[5] = { "LP", "BP", "HP", "Notch", "AP" };
+        float m = clamp(getValue(), 0.f, 4.f);
+        int seg = std::min((int)m, 3);
+        int pct = (int)roundf((m - seg) * 100.f);
+        if (pct == 0)
+            return names[seg];
+        if (pct == 100)
+            return names[seg + 1];
+        return string::f("%s > %s %d%%", names[seg], names[seg + 1], pct);
+    }
+};
+
 struct Vortex : Module {
     enum ParamId {
         MODE_PARAM,
@@ -22,6 +39,17 @@ struct Vortex : Module {
         RESONANCE_CV_ATTEN_PARAM,
         DRIVE_CV_ATTEN_PARAM,
 
+        // Morph (morph modes only)
+        MORPH_PARAM,
+        MORPH_CV_ATTEN_PARAM,
+
+        // Hidden (right-click menu / MetaModule)
+        FIXED_RATE_PARAM,
+        FOLLOW_AMOUNT_PARAM,
+        FOLLOW_ATTACK_PARAM,
+        FOLLOW_RELEASE_PARAM,
+        FOLLOW_RATE_PARAM,
+
         PARAMS_LEN
     };
     enum InputId {
@@ -30,6 +58,7 @@ struct Vortex : Module {
         CUTOFF_CV_INPUT,
         RESONANCE_CV_INPUT,
         DRIVE_CV_INPUT,
+        MORPH_CV_INPUT,
 
         INPUTS_LEN
     };
@@ -41,16 +70,34 @@ struct Vortex : Module {
         LIGHTS_LEN
     };
 
-    // Filter state
-    vortex::Filter1 f1;
-    vortex::Filter2 f2a, f2b;
-    int lastMode = -1;
+    vortex::EngineState engineState;
+    vortex::FixedRateState fixedRate;
+    bool bypassed = false;      // set by processBypass, engine reset on resume
+
+    // Settings edited from the UI (mode display, menu, MetaModule). Published
+    // as versioned snapshots; see Four for the same scheme.
+    struct Settings {
+        int mode = 0;
+        bool fixedRate = false;
+        float followAmount = 0.f;
+        float followAttack = 0.005f;    // seconds
+        float followRelease = 0.1f;     // seconds
+        int controlDivision = 16;
+    };
+
+    wintoid::SnapshotBuffer<Settings> settingsBuffer;
+    uint32_t settingsSeen = 0;
+    Settings settings;
+    dsp::ClockDivider settingsDivider;
+
+    // Hidden input capture (context menu > Developer), ~0.7s of buffering at 48kHz
+    wintoid::CaptureRecorder capture { vortex::CAPTURE_CHANNELS, 1 << 15 };
 
     Vortex() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 
         // Main params
-        configParam(MODE_PARAM, 0.f, 11.f, 0.f, "Mode");
+        configParam(MODE_PARAM, 0.f, (float)(vortex::NUM_MODES - 1), 0.f, "Mode");
         getParamQuantity(MODE_PARAM)->snapEnabled = true;
 
         auto* cpq = configParam<CutoffParamQuantity>(CUTOFF_PARAM, 20.f, 20000.f, 1000.f, "Cutoff");
@@ -58,153 +105,158 @@ struct Vortex : Module {
 
         configParam(RESONANCE_PARAM, 0.f, 1.f, 0.f, "Resonance", "%", 0.f, 100.f);
         configParam(DRIVE_PARAM, 0.f, 1.f, 0.f, "Drive", "%", 0.f, 100.f);
+        configParam<MorphParamQuantity>(MORPH_PARAM, 0.f, 4.f, 0.f, "Morph");
 
         // CV attenuverters
         configParam(CUTOFF_CV_ATTEN_PARAM, -1.f, 1.f, 0.f, "Cutoff CV", "%", 0.f, 100.f);
         configParam(RESONANCE_CV_ATTEN_PARAM, -1.f, 1.f, 0.f, "Resonance CV", "%", 0.f, 100.f);
         configParam(DRIVE_CV_ATTEN_PARAM, -1.f, 1.f, 0.f, "Drive CV", "%", 0.f, 100.f);
+        configParam(MORPH_CV_ATTEN_PARAM, -1.f, 1.f, 0.f, "Morph CV", "%", 0.f, 100.f);
+
+        // Run drive + filter at 44.1-88.2kHz when the host rate is 88.2kHz or above
+        configSwitch(FIXED_RATE_PARAM, 0.f, 1.f, 0.f, "Fixed internal rate", {"Off", "On"});
+
+        // Envelope follower on the audio input, sweeping cutoff (up to 6 octaves at 5V)
+        configParam(FOLLOW_AMOUNT_PARAM, -1.f, 1.f, 0.f, "Follower > Cutoff", "%", 0.f, 100.f);
+        configParam(FOLLOW_ATTACK_PARAM, log2f(0.0005f), log2f(1.f), log2f(0.005f), "Follower Attack", " ms", 2.f, 1000.f);
+        configParam(FOLLOW_RELEASE_PARAM, log2f(0.005f), log2f(5.f), log2f(0.1f), "Follower Release", " ms", 2.f, 1000.f);
+        configSwitch(FOLLOW_RATE_PARAM, 0.f, 3.f, 1.f, "Follower Update", {"Every 8 samples", "Every 16 samples", "Every 32 samples", "Every 64 samples"});
+        getParamQuantity(FOLLOW_RATE_PARAM)->description = "Every sample while Cutoff CV is patched";
 
         // Inputs
         configInput(AUDIO_INPUT, "Audio");
         configInput(CUTOFF_CV_INPUT, "Cutoff CV");
         configInput(RESONANCE_CV_INPUT, "Resonance CV");
         configInput(DRIVE_CV_INPUT, "Drive CV");
+        configInput(MORPH_CV_INPUT, "Morph CV");
 
         // Output
         configOutput(AUDIO_OUTPUT, "Audio");
-    }
+        configBypass(AUDIO_INPUT, AUDIO_OUTPUT);
 
-    void process(const ProcessArgs& args) override {
-        float fs = args.sampleRate;
+        settingsDivider.setDivision(32);
+        applySettings(readSettings());
+    }
 
-        // --- Read input ---
-        float input = inputs[AUDIO_INPUT].getVoltage() / 5.f;  // normalize to ~+/-1
+    Settings readSettings() {
+        Settings st;
+        st.mode = (int)params[MODE_PARAM].getValue();
+        st.fixedRate = params[FIXED_RATE_PARAM].getValue() > 0.5f;
+        st.followAmount = params[FOLLOW_AMOUNT_PARAM].getValue();
+        st.followAttack = vortex::panel_follow_time(params[FOLLOW_ATTACK_PARAM].getValue());
+        st.followRelease = vortex::panel_follow_time(params[FOLLOW_RELEASE_PARAM].getValue());
+        st.controlDivision = vortex::panel_control_division(params[FOLLOW_RATE_PARAM].getValue());
+        return st;
+    }
 
-        // --- Mode ---
-        int mode = (int)params[MODE_PARAM].getValue();
-
-        // Reset filter state when mode changes
-        if (mode != lastMode) {
-            f1.reset();
-            f2a.reset();
-            f2b.reset();
-            lastMode = mode;
-        }
+    // Audio thread
+    void applySettings(const Settings& st) {
+        bool rateChanged = st.fixedRate != settings.fixedRate;
+        settings = st;
+        if (rateChanged)
+            configureFixedRate();
+    }
 
-        // --- Cutoff ---
-        float cutoff = params[CUTOFF_PARAM].getValue();
+    void configureFixedRate() {
+        vortex::engine_configure_fixed_rate(engineState, fixedRate,
+                                            APP->engine->getSampleRate(), settings.fixedRate);
+    }
 
-        if (inputs[CUTOFF_CV_INPUT].isConnected()) {
-            float cutoffCv = inputs[CUTOFF_CV_INPUT].getVoltage()
-                           * params[CUTOFF_CV_ATTEN_PARAM].getValue();
-            cutoff *= vortex::voct_to_mult(cutoffCv);
-        }
+    void onSampleRateChange(const SampleRateChangeEvent& e) override {
+        vortex::engine_configure_fixed_rate(engineState, fixedRate, e.sampleRate, settings.fixedRate);
+    }
 
-        cutoff = clamp(cutoff, 20.f, 20000.f);
+    // UI thread: publish settings after a widget edits params directly
+    void publishSettings() {
+        settingsBuffer.publish(readSettings());
+    }
 
-        // --- Resonance ---
-        // Map knob 0-1 to damping 0.707-0.01
-        float resoParam = params[RESONANCE_PARAM].getValue();
-        float damping = 0.707f * (1.f - resoParam) + 0.01f * resoParam;
+    // Bypassed: Rack copies the input to the output (configBypass) and the
+    // engine is skipped. It restarts from clean state, so no stale
+    // resonance rings out when the bypass is released.
+    void processBypass(const ProcessArgs& args) override {
+        Module::processBypass(args);
+        bypassed = true;
+    }
 
-        if (inputs[RESONANCE_CV_INPUT].isConnected()) {
-            float resoCv = inputs[RESONANCE_CV_INPUT].getVoltage()
-                         * params[RESONANCE_CV_ATTEN_PARAM].getValue() * 0.2f;
-            damping -= resoCv;
-            damping = clamp(damping, 0.01f, 0.707f);
+    void process(const ProcessArgs& args) override {
+        if (bypassed) {
+            engineState = vortex::EngineState();
+            fixedRate.resampler.reset();
+            bypassed = false;
         }
 
-        // --- Drive ---
-        float drv = params[DRIVE_PARAM].getValue();
-        if (inputs[DRIVE_CV_INPUT].isConnected()) {
-            float driveCv = inputs[DRIVE_CV_INPUT].getVoltage()
-                          * params[DRIVE_CV_ATTEN_PARAM].getValue() / 10.f;
-            drv = clamp(drv + driveCv, 0.f, 1.f);
-        }
+        // Widget edits arrive as snapshots; knob, preset and undo changes
+        // are caught by a control-rate rescan
+        Settings pending;
+        if (settingsBuffer.poll(settingsSeen, pending))
+            applySettings(pending);
+        else if (settingsDivider.process())
+            applySettings(readSettings());
 
-        // --- Drive stage ---
-        float signal = input;
-        if (drv > 0.f) {
-            float driveGain = 1.f + drv * 9.f;
-            signal = vortex::soft_clip(signal * driveGain);
-        }
+        vortex::EngineParams ep;
 
-        // --- Filter ---
-        float wet = 0.f;
-
-        switch (mode) {
-        case 0: // LP 6dB
-            vortex::filter1_configure_lp(f1, fs, cutoff);
-            wet = f1.process_lp(signal);
-            break;
-        case 1: // LP 12dB
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_LP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_LP);
-            break;
-        case 2: // LP 24dB
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_LP);
-            vortex::filter2_configure(f2b, fs, cutoff, damping, vortex::F2_LP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_LP);
-            wet = vortex::filter2_process(f2b, wet, vortex::F2_LP);
-            break;
-        case 3: // HP 6dB
-            vortex::filter1_configure_hp(f1, fs, cutoff);
-            wet = f1.process_hp(signal);
-            break;
-        case 4: // HP 12dB
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_HP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_HP);
-            break;
-        case 5: // HP 24dB
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_HP);
-            vortex::filter2_configure(f2b, fs, cutoff, damping, vortex::F2_HP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_HP);
-            wet = vortex::filter2_process(f2b, wet, vortex::F2_HP);
-            break;
-        case 6: // BP
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_BP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_BP);
-            break;
-        case 7: // BP+
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_BP);
-            vortex::filter2_configure(f2b, fs, cutoff, damping, vortex::F2_BP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_BP);
-            wet = vortex::filter2_process(f2b, wet, vortex::F2_BP);
-            break;
-        case 8: // Notch
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_NOTCH);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_NOTCH);
-            break;
-        case 9: // Notch+
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_NOTCH);
-            vortex::filter2_configure(f2b, fs, cutoff, damping, vortex::F2_NOTCH);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_NOTCH);
-            wet = vortex::filter2_process(f2b, wet, vortex::F2_NOTCH);
-            break;
-        case 10: // AP
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_AP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_AP);
-            break;
-        case 11: // AP+
-            vortex::filter2_configure(f2a, fs, cutoff, damping, vortex::F2_AP);
-            vortex::filter2_configure(f2b, fs, cutoff, damping, vortex::F2_AP);
-            wet = vortex::filter2_process(f2a, signal, vortex::F2_AP);
-            wet = vortex::filter2_process(f2b, wet, vortex::F2_AP);
-            break;
+        // --- Read input ---
+        float input = inputs[AUDIO_INPUT].getVoltage() / 5.f;  // normalize to ~+/-1
+
+        // --- Mode ---
+        ep.mode = settings.mode;
+
+        // --- Cutoff, resonance, drive, morph: knob + attenuated CV (panel.h) ---
+        ep.cutoff = vortex::panel_cutoff(params[CUTOFF_PARAM].getValue(),
+                                         inputs[CUTOFF_CV_INPUT].getVoltage(),
+                                         params[CUTOFF_CV_ATTEN_PARAM].getValue());
+        ep.damping = vortex::panel_damping(params[RESONANCE_PARAM].getValue(),
+                                           inputs[RESONANCE_CV_INPUT].getVoltage(),
+                                           params[RESONANCE_CV_ATTEN_PARAM].getValue());
+        ep.drive = vortex::panel_drive(params[DRIVE_PARAM].getValue(),
+                                       inputs[DRIVE_CV_INPUT].getVoltage(),
+                                       params[DRIVE_CV_ATTEN_PARAM].getValue());
+        ep.morph = vortex::panel_morph(params[MORPH_PARAM].getValue(),
+                                       inputs[MORPH_CV_INPUT].getVoltage(),
+                                       params[MORPH_CV_ATTEN_PARAM].getValue());
+
+        // --- Envelope follower ---
+        ep.followAmount = settings.followAmount;
+        ep.followAttack = settings.followAttack;
+        ep.followRelease = settings.followRelease;
+        // A patched cutoff CV may be audio rate: keep per-sample coefficients
+        ep.controlDivision = inputs[CUTOFF_CV_INPUT].isConnected() ? 1 : settings.controlDivision;
+
+        if (capture.isRecording()) {
+            float frame[vortex::CAPTURE_CHANNELS];
+            vortex::engine_capture_frame(ep, input, frame);
+            capture.record(frame);
         }
 
-        // Flush denormals
-        f1.z = vortex::flush_denormal(f1.z);
-        f2a.z0 = vortex::flush_denormal(f2a.z0);
-        f2a.z1 = vortex::flush_denormal(f2a.z1);
-        f2b.z0 = vortex::flush_denormal(f2b.z0);
-        f2b.z1 = vortex::flush_denormal(f2b.z1);
+        // --- Drive + filter ---
+        float wet = vortex::engine_process_fixed_rate(engineState, fixedRate, ep, args.sampleRate, input);
 
         // Output at +/-5V
         outputs[AUDIO_OUTPUT].setVoltage(wet * 5.f);
     }
+
+    // Internal rate and added latency, e.g. "48 kHz, 95 smp"
+    std::string fixedRateInfo() {
+        if (!fixedRate.active())
+            return "";
+        return string::f("%g kHz, %d smp", fixedRate.internalRate / 1000.f, fixedRate.latency());
+    }
+
+    void setCapture(bool on) {
+        if (on)
+            capture.start(capturePath("Vortex", id), "VRTX", APP->engine->getSampleRate());
+        else
+            capture.stop();
+    }
 };
 
+// Patch param ids must match the offline renderer's layout (panel.h)
+static_assert(Vortex::MORPH_PARAM == vortex::PANEL_MORPH, "panel.h out of date");
+static_assert(Vortex::FIXED_RATE_PARAM == vortex::PANEL_FIXED_RATE, "panel.h out of date");
+static_assert(Vortex::FOLLOW_RATE_PARAM == vortex::PANEL_FOLLOW_RATE, "panel.h out of date");
+static_assert(Vortex::PARAMS_LEN == vortex::PANEL_PARAMS_LEN, "panel.h out of date");
+
 #include "layout.h"
 
 static const char* modeStrings[] = {
@@ -212,7 +264,8 @@ static const char* modeStrings[] = {
     "HP 6dB", "HP 12dB", "HP 24dB",
     "BP", "BP+",
     "Notch", "Notch+",
-    "AP", "AP+"
+    "AP", "AP+",
+    "Morph", "Morph+"
 };
 
 struct ModeDisplay : Widget {
@@ -255,17 +308,21 @@ struct ModeDisplay : Widget {
 
         if (e.action == GLFW_PRESS && e.button == GLFW_MOUSE_BUTTON_LEFT) {
             int mode = (int)module->params[Vortex::MODE_PARAM].getValue();
-            mode = (mode + 1) % 12;
+            mode = (mode + 1) % vortex::NUM_MODES;
             module->params[Vortex::MODE_PARAM].setValue((float)mode);
+            module->publishSettings();
             e.consume(this);
         }
         else if (e.action == GLFW_PRESS && e.button == GLFW_MOUSE_BUTTON_RIGHT) {
             ui::Menu* menu = createMenu();
             menu->addChild(createMenuLabel("Filter Mode"));
-            for (int i = 0; i < 12; i++) {
+            for (int i = 0; i < vortex::NUM_MODES; i++) {
                 int modeIdx = i;
                 menu->addChild(createMenuItem(modeStrings[i], "",
-                    [=]() { module->params[Vortex::MODE_PARAM].setValue((float)modeIdx); }));
+                    [=]() {
+                        module->params[Vortex::MODE_PARAM].setValue((float)modeIdx);
+                        module->publishSettings();
+                    }));
             }
             e.consume(this);
         }
@@ -339,6 +396,7 @@ struct PanelLabels : Widget {
         nvgText(args.vg, mm2px(CUTOFF_KNOB_X), mm2px(CUTOFF_KNOB_Y - 6.0f), "Cutoff", nullptr);
         nvgText(args.vg, mm2px(RESONANCE_KNOB_X), mm2px(RESONANCE_KNOB_Y - 6.0f), "Reso", nullptr);
         nvgText(args.vg, mm2px(DRIVE_KNOB_X), mm2px(DRIVE_KNOB_Y - 6.0f), "Drive", nullptr);
+        nvgText(args.vg, mm2px(MORPH_KNOB_X), mm2px(MORPH_KNOB_Y - 6.0f), "Morph", nullptr);
 
         // Audio I/O labels
         nvgFontSize(args.vg, 9);
@@ -395,10 +453,46 @@ struct VortexWidget : ModuleWidget {
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(CV_DRIVE_JACK_X, CV_DRIVE_JACK_Y)), module, Vortex::DRIVE_CV_INPUT));
         addParam(createParamCentered<Trimpot>(mm2px(Vec(CV_DRIVE_ATTEN_X, CV_DRIVE_ATTEN_Y)), module, Vortex::DRIVE_CV_ATTEN_PARAM));
 
+        addParam(createParamCentered<RoundSmallBlackKnob>(mm2px(Vec(MORPH_KNOB_X, MORPH_KNOB_Y)), module, Vortex::MORPH_PARAM));
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(CV_MORPH_JACK_X, CV_MORPH_JACK_Y)), module, Vortex::MORPH_CV_INPUT));
+        addParam(createParamCentered<Trimpot>(mm2px(Vec(CV_MORPH_ATTEN_X, CV_MORPH_ATTEN_Y)), module, Vortex::MORPH_CV_ATTEN_PARAM));
+
         // Audio I/O
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(AUDIO_IN_X, AUDIO_IN_Y)), module, Vortex::AUDIO_INPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(AUDIO_OUT_X, AUDIO_OUT_Y)), module, Vortex::AUDIO_OUTPUT));
     }
+
+    void appendContextMenu(Menu* menu) override {
+        Vortex* module = getModule<Vortex>();
+
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createBoolMenuItem("Fixed internal rate", module->fixedRateInfo(),
+            [=]() { return module->params[Vortex::FIXED_RATE_PARAM].getValue() > 0.5f; },
+            [=](bool on) {
+                module->params[Vortex::FIXED_RATE_PARAM].setValue(on ? 1.f : 0.f);
+                module->publishSettings();
+            }));
+
+        menu->addChild(createSubmenuItem("Envelope follower", "", [=](Menu* menu) {
+            menu->addChild(createMenuLabel("Audio input > cutoff"));
+            menu->addChild(new ParamSlider(module->getParamQuantity(Vortex::FOLLOW_AMOUNT_PARAM)));
+            menu->addChild(new ParamSlider(module->getParamQuantity(Vortex::FOLLOW_ATTACK_PARAM)));
+            menu->addChild(new ParamSlider(module->getParamQuantity(Vortex::FOLLOW_RELEASE_PARAM)));
+            menu->addChild(createIndexSubmenuItem("Update rate",
+                {"Every 8 samples", "Every 16 samples", "Every 32 samples", "Every 64 samples"},
+                [=]() { return (size_t)module->params[Vortex::FOLLOW_RATE_PARAM].getValue(); },
+                [=](size_t i) {
+                    module->params[Vortex::FOLLOW_RATE_PARAM].setValue((float)i);
+                    module->publishSettings();
+                }));
+        }));
+
+        menu->addChild(createSubmenuItem("Developer", "", [=](Menu* menu) {
+            menu->addChild(createBoolMenuItem("Capture inputs to file", "",
+                [=]() { return module->capture.isRecording(); },
+                [=](bool on) { module->setCapture(on); }));
+        }));
+    }
 };
 
 Model* modelVortex = createModel<Vortex, VortexWidget>("VortexMM");
@@ -171,54 +171,122 @@ struct Filter2
     }
 };
 
-// Configure second-order filter coefficients
+// Intermediate values shared by all second-order response types
+struct Filter2Design
+{
+    float w, w_sq, sigma, sigma_sq, v, k, damping;
+};
+
+// Compute the shared state-update coefficients (b0, b1)
 // Uses Sigma frequency warping for audio-rate modulation quality
 // damping = 1/(2*Q), e.g. 0.707 = Butterworth, lower = more resonant
-inline void filter2_configure(Filter2& f, float sample_rate, float cutoff_hz,
-                               float damping, Filter2Type type)
+inline Filter2Design filter2_design(Filter2& f, float sample_rate, float cutoff_hz, float damping)
 {
-    float w = sample_rate / (SQRT2 * PI * cutoff_hz);
-    float sigma = SQRT2 * INV_PI;
-    if (w > INV_PI * SQRT2)
-        sigma = 0.57735268f * (0.11686715f - w * w) / (0.09186588f - w * w);
-
-    float w_sq = w * w;
-    float sigma_sq = sigma * sigma;
+    Filter2Design d;
+    d.w = sample_rate / (SQRT2 * PI * cutoff_hz);
+    d.sigma = SQRT2 * INV_PI;
+    if (d.w > INV_PI * SQRT2)
+        d.sigma = 0.57735268f * (0.11686715f - d.w * d.w) / (0.09186588f - d.w * d.w);
+
+    d.w_sq = d.w * d.w;
+    d.sigma_sq = d.sigma * d.sigma;
+    d.damping = damping;
     float zeta_sq = damping * damping;
 
     // vk computation (state-space eigenvalue decomposition)
-    float t = w_sq * (2.0f * zeta_sq - 1.0f);
-    float v = sqrtf(w_sq * w_sq + sigma_sq * (2.0f * t + sigma_sq));
-    float k = t + sigma_sq;
+    float t = d.w_sq * (2.0f * zeta_sq - 1.0f);
+    d.v = sqrtf(d.w_sq * d.w_sq + d.sigma_sq * (2.0f * t + d.sigma_sq));
+    d.k = t + d.sigma_sq;
 
-    f.b0 = 1.0f / (v + sqrtf(v + k) + 0.5f);
-    f.b1 = sqrtf(2.0f * v);
+    f.b0 = 1.0f / (d.v + sqrtf(d.v + d.k) + 0.5f);
+    f.b1 = sqrtf(2.0f * d.v);
+    return d;
+}
 
+// Output taps for one response type: y = theta*b3 + z1*b2 + z0*c0
+// c0 is 1 for LP, Notch, AllPass and 0 for HP, BP (see process_lna/process_hb)
+inline void filter2_taps(const Filter2& f, const Filter2Design& d, Filter2Type type,
+                         float& b2, float& b3, float& c0)
+{
     switch (type)
     {
     case F2_LP:
-        f.b2 = 2.0f * sigma_sq / f.b1;
-        f.b3 = 0.5f + sigma_sq + SQRT2 * sigma;
+        b2 = 2.0f * d.sigma_sq / f.b1;
+        b3 = 0.5f + d.sigma_sq + SQRT2 * d.sigma;
+        c0 = 1.0f;
         break;
     case F2_HP:
-        f.b2 = 2.0f * w_sq / f.b1;
-        f.b3 = w_sq;
+        b2 = 2.0f * d.w_sq / f.b1;
+        b3 = d.w_sq;
+        c0 = 0.0f;
         break;
     case F2_BP:
-        f.b2 = 4.0f * w * damping * sigma / f.b1;
-        f.b3 = 2.0f * w * damping * (sigma + INV_SQRT2);
+        b2 = 4.0f * d.w * d.damping * d.sigma / f.b1;
+        b3 = 2.0f * d.w * d.damping * (d.sigma + INV_SQRT2);
+        c0 = 0.0f;
         break;
     case F2_NOTCH:
-        f.b2 = 2.0f * (w_sq - sigma_sq) / f.b1;
-        f.b3 = 0.5f + w_sq - sigma_sq;
+        b2 = 2.0f * (d.w_sq - d.sigma_sq) / f.b1;
+        b3 = 0.5f + d.w_sq - d.sigma_sq;
+        c0 = 1.0f;
         break;
     case F2_AP:
-        f.b2 = f.b1;
-        f.b3 = 0.5f + v - sqrtf(v + k);
+    default:
+        b2 = f.b1;
+        b3 = 0.5f + d.v - sqrtf(d.v + d.k);
+        c0 = 1.0f;
         break;
     }
 }
 
+// Configure second-order filter coefficients
+// Uses Sigma frequency warping for audio-rate modulation quality
+// damping = 1/(2*Q), e.g. 0.707 = Butterworth, lower = more resonant
+inline void filter2_configure(Filter2& f, float sample_rate, float cutoff_hz,
+                               float damping, Filter2Type type)
+{
+    Filter2Design d = filter2_design(f, sample_rate, cutoff_hz, damping);
+    float c0;
+    filter2_taps(f, d, type, f.b2, f.b3, c0);
+}
+
+// Morph order: position 0-4 sweeps LP -> BP -> HP -> Notch -> AP
+static const Filter2Type MORPH_ORDER[5] = { F2_LP, F2_BP, F2_HP, F2_NOTCH, F2_AP };
+
+// Configure a continuous response morph by blending the output taps of the
+// two neighbouring types. The state update (b0, b1) does not depend on the
+// type, so the morph never needs a state reset.
+// Returns the z0 tap gain for filter2_process_morph.
+inline float filter2_configure_morph(Filter2& f, float sample_rate, float cutoff_hz,
+                                      float damping, float morph)
+{
+    Filter2Design d = filter2_design(f, sample_rate, cutoff_hz, damping);
+
+    if (morph < 0.0f) morph = 0.0f;
+    if (morph > 4.0f) morph = 4.0f;
+    int seg = (int)morph;
+    if (seg > 3) seg = 3;
+    float t = morph - (float)seg;
+
+    float b2a, b3a, c0a, b2b, b3b, c0b;
+    filter2_taps(f, d, MORPH_ORDER[seg], b2a, b3a, c0a);
+    filter2_taps(f, d, MORPH_ORDER[seg + 1], b2b, b3b, c0b);
+
+    f.b2 = b2a + t * (b2b - b2a);
+    f.b3 = b3a + t * (b3b - b3a);
+    return c0a + t * (c0b - c0a);
+}
+
+// Process one sample with blended output taps (see filter2_configure_morph)
+inline float filter2_process_morph(Filter2& f, float x, float z0_gain)
+{
+    float theta = (x - f.z0 - f.z1 * f.b1) * f.b0;
+    float y = theta * f.b3 + f.z1 * f.b2 + f.z0 * z0_gain;
+    f.z0 += theta;
+    f.z1 = -f.z1 - theta * f.b1;
+    return y;
+}
+
 // Process one sample through a second-order filter
 inline float filter2_process(Filter2& f, float x, Filter2Type type)
 {
@@ -228,4 +296,167 @@ inline float filter2_process(Filter2& f, float x, Filter2Type type)
         return f.process_lna(x);
 }
 
+// ============================================================
+// Envelope follower (peak, separate attack and release)
+// ============================================================
+
+struct EnvelopeFollower
+{
+    float env = 0.0f;
+    float attackCoef = 0.0f;
+    float releaseCoef = 0.0f;
+
+    void reset() { env = 0.0f; }
+
+    // Times are to ~63% of a step (one time constant)
+    void configure(float sample_rate, float attack_s, float release_s)
+    {
+        attackCoef = expf(-1.0f / (fmaxf(attack_s, 1e-5f) * sample_rate));
+        releaseCoef = expf(-1.0f / (fmaxf(release_s, 1e-5f) * sample_rate));
+    }
+
+    float process(float x)
+    {
+        float rect = fabsf(x);
+        float coef = (rect > env) ? attackCoef : releaseCoef;
+        env = rect + coef * (env - rect);
+        return env;
+    }
+};
+
+// ============================================================
+// Polyphase FIR resampler (integer factor)
+// Decimates the host-rate input to host/factor, and interpolates the
+// processed internal-rate signal back up. Both directions share one
+// Kaiser-windowed sinc prototype with its cutoff at the internal Nyquist.
+// Only the polyphase branch needed for each output is evaluated, so the
+// cost is 2 * RESAMPLE_TAPS_PER_PHASE multiply-adds per host sample.
+// ============================================================
+
+static const int RESAMPLE_MAX_FACTOR = 8;
+static const int RESAMPLE_TAPS_PER_PHASE = 24;
+static const int RESAMPLE_MAX_TAPS = RESAMPLE_MAX_FACTOR * RESAMPLE_TAPS_PER_PHASE;
+static const float RESAMPLE_KAISER_BETA = 6.0f;    // ~60 dB stopband
+
+// Zeroth-order modified Bessel function (Kaiser window)
+inline float bessel_i0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    float q = x * x * 0.25f;
+    for (int k = 1; k < 32; k++) {
+        term *= q / (float)(k * k);
+        sum += term;
+        if (term < sum * 1e-9f)
+            break;
+    }
+    return sum;
+}
+
+struct PolyphaseResampler
+{
+    int factor = 1;
+    int taps = 0;                                   // factor * RESAMPLE_TAPS_PER_PHASE
+    float h[RESAMPLE_MAX_TAPS];                     // decimation prototype (unity DC gain)
+    float hUp[RESAMPLE_MAX_TAPS];                   // interpolation branches, phase-major, gain * factor
+    float down[2 * RESAMPLE_MAX_TAPS];              // host-rate history, mirrored for a contiguous window
+    float up[2 * RESAMPLE_TAPS_PER_PHASE];          // internal-rate history, mirrored
+    int downPos = 0;
+    int upPos = 0;
+    int inCount = 0;                                // host samples since the last decimated output
+    int outPhase = 0;                               // interpolation branch for the next host output
+
+    PolyphaseResampler() { design(1); }
+
+    // Latency of a decimate + interpolate round trip, in host samples
+    int latency() const { return factor > 1 ? taps - 1 : 0; }
+
+    void design(int newFactor)
+    {
+        if (newFactor < 1) newFactor = 1;
+        if (newFactor > RESAMPLE_MAX_FACTOR) newFactor = RESAMPLE_MAX_FACTOR;
+        factor = newFactor;
+        taps = factor * RESAMPLE_TAPS_PER_PHASE;
+
+        // Windowed sinc, cutoff at 0.5 / factor of the host rate
+        float center = 0.5f * (float)(taps - 1);
+        float fc = 0.5f / (float)factor;
+        float i0Beta = bessel_i0(RESAMPLE_KAISER_BETA);
+        float sum = 0.0f;
+        for (int j = 0; j < taps; j++) {
+            float t = (float)j - center;
+            float sinc = (fabsf(t) < 1e-6f) ? 2.0f * fc : sinf(TWO_PI * fc * t) / (PI * t);
+            float r = t / center;
+            float win = bessel_i0(RESAMPLE_KAISER_BETA * sqrtf(fmaxf(0.0f, 1.0f - r * r))) / i0Beta;
+            h[j] = sinc * win;
+            sum += h[j];
+        }
+        for (int j = 0; j < taps; j++)
+            h[j] /= sum;
+
+        // Branch p holds h[p], h[p + factor], h[p + 2*factor], ...
+        for (int p = 0; p < factor; p++)
+            for (int k = 0; k < RESAMPLE_TAPS_PER_PHASE; k++)
+                hUp[p * RESAMPLE_TAPS_PER_PHASE + k] = h[p + k * factor] * (float)factor;
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (int j = 0; j < 2 * RESAMPLE_MAX_TAPS; j++)
+            down[j] = 0.0f;
+        for (int k = 0; k < 2 * RESAMPLE_TAPS_PER_PHASE; k++)
+            up[k] = 0.0f;
+        downPos = 0;
+        upPos = 0;
+        inCount = factor - 1;   // first host sample yields an internal sample
+        outPhase = 0;
+    }
+
+    // Push one host-rate sample. Returns true (and the decimated sample)
+    // once every `factor` calls.
+    bool decimate(float x, float& out)
+    {
+        // Newest sample at down[downPos], mirrored at downPos + taps
+        downPos = (downPos == 0) ? taps - 1 : downPos - 1;
+        down[downPos] = x;
+        down[downPos + taps] = x;
+
+        if (++inCount < factor)
+            return false;
+        inCount = 0;
+
+        const float* window = &down[downPos];
+        float acc = 0.0f;
+        for (int j = 0; j < taps; j++)
+            acc += h[j] * window[j];
+        out = acc;
+        return true;
+    }
+
+    // Push one processed internal-rate sample; call right after decimate()
+    // returns true
+    void interpolate_push(float y)
+    {
+        upPos = (upPos == 0) ? RESAMPLE_TAPS_PER_PHASE - 1 : upPos - 1;
+        up[upPos] = y;
+        up[upPos + RESAMPLE_TAPS_PER_PHASE] = y;
+        outPhase = 0;
+    }
+
+    // Next host-rate output sample (one call per host sample)
+    float interpolate_pull()
+    {
+        const float* branch = &hUp[outPhase * RESAMPLE_TAPS_PER_PHASE];
+        const float* window = &up[upPos];
+        float acc = 0.0f;
+        for (int k = 0; k < RESAMPLE_TAPS_PER_PHASE; k++)
+            acc += branch[k] * window[k];
+        if (outPhase < factor - 1)
+            outPhase++;
+        return acc;
+    }
+};
+
 } // namespace vortex
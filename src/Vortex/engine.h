@@ -0,0 +1,425 @@
+#pragma once
+
+// Vortex drive + filter engine.
+// No VCV Rack API dependencies — testable on desktop.
+
+#include "dsp.h"
+#include "../events.h"
+
+namespace vortex {
+
+static const int NUM_MODES = 14;
+
+// Morph modes: continuous LP -> BP -> HP -> Notch -> AP response
+static const int MODE_MORPH = 12;
+static const int MODE_MORPH_CASCADE = 13;
+
+// Filter coefficients interpolated between control-rate updates:
+// f1 b0-b1, f2a b0-b3, f2b b0-b3, morphZ0
+static const int NUM_COEFS = 11;
+
+// Octaves of cutoff sweep for a full-scale (5V) follower envelope
+static const float FOLLOW_OCTAVES = 6.0f;
+
+struct EngineState
+{
+    Filter1 f1;
+    Filter2 f2a, f2b;
+    float morphZ0 = 1.0f;       // z0 tap gain in morph modes
+    int lastMode = -1;
+
+    // Envelope follower -> cutoff (control rate)
+    EnvelopeFollower follower;
+    float coefStep[NUM_COEFS] = {};
+    int controlCounter = 0;     // samples until the next coefficient update
+};
+
+struct EngineParams
+{
+    int mode = 0;               // 0-13, see modeStrings in Vortex.cpp
+    float cutoff = 1000.0f;     // Hz, 20-20000
+    float damping = 0.707f;     // 0.707 (Butterworth) - 0.01 (near self-oscillation)
+    float drive = 0.0f;         // 0.0-1.0
+    float morph = 0.0f;         // 0.0-4.0, morph modes only
+
+    // Envelope follower on the input, driving cutoff
+    float followAmount = 0.0f;  // -1.0-1.0 (0 = off, negative ducks)
+    float followAttack = 0.005f;    // seconds
+    float followRelease = 0.1f;     // seconds
+    int controlDivision = 16;   // samples per coefficient update while following,
+                                // 1 = every sample (audio-rate cutoff CV)
+};
+
+// Parameter ids for timestamped events (see apply_param_event)
+enum EngineParamId
+{
+    PARAM_MODE = 0,
+    PARAM_CUTOFF,
+    PARAM_DAMPING,
+    PARAM_DRIVE,
+    PARAM_MORPH,
+    PARAM_FOLLOW_AMOUNT,
+    PARAM_FOLLOW_ATTACK,
+    PARAM_FOLLOW_RELEASE,
+    PARAM_CONTROL_DIVISION,
+    PARAM_COUNT
+};
+
+// Apply one parameter change.
+// Returns true if filter coefficients need to be recomputed.
+inline bool apply_param_event(EngineParams& params, int id, float value)
+{
+    switch (id) {
+    case PARAM_MODE:
+        params.mode = (int)value;
+        if (params.mode < 0) params.mode = 0;
+        if (params.mode >= NUM_MODES) params.mode = NUM_MODES - 1;
+        return true;
+    case PARAM_CUTOFF:  params.cutoff = value; return true;
+    case PARAM_DAMPING: params.damping = value; return true;
+    case PARAM_DRIVE:   params.drive = value; return false;
+    case PARAM_MORPH:   params.morph = value; return true;
+    case PARAM_FOLLOW_AMOUNT:  params.followAmount = value; return true;
+    case PARAM_FOLLOW_ATTACK:  params.followAttack = value; return false;
+    case PARAM_FOLLOW_RELEASE: params.followRelease = value; return false;
+    case PARAM_CONTROL_DIVISION:
+        params.controlDivision = (int)value;
+        if (params.controlDivision < 1) params.controlDivision = 1;
+        return false;
+    }
+    return false;
+}
+
+// Current value of one parameter (inverse of apply_param_event)
+inline float engine_param_value(const EngineParams& params, int id)
+{
+    switch (id) {
+    case PARAM_MODE:    return (float)params.mode;
+    case PARAM_CUTOFF:  return params.cutoff;
+    case PARAM_DAMPING: return params.damping;
+    case PARAM_DRIVE:   return params.drive;
+    case PARAM_MORPH:   return params.morph;
+    case PARAM_FOLLOW_AMOUNT:  return params.followAmount;
+    case PARAM_FOLLOW_ATTACK:  return params.followAttack;
+    case PARAM_FOLLOW_RELEASE: return params.followRelease;
+    case PARAM_CONTROL_DIVISION: return (float)params.controlDivision;
+    }
+    return 0.0f;
+}
+
+// Capture frame layout (see capture.h): one channel per EngineParamId,
+// followed by the normalized audio input.
+static const int CAPTURE_CHANNELS = PARAM_COUNT + 1;
+static const int CAPTURE_INPUT = PARAM_COUNT;
+
+inline void engine_capture_frame(const EngineParams& params, float input, float frame[CAPTURE_CHANNELS])
+{
+    for (int id = 0; id < PARAM_COUNT; id++)
+        frame[id] = engine_param_value(params, id);
+    frame[CAPTURE_INPUT] = input;
+}
+
+// Filter2 response type used by each mode
+// (modes 0 and 3 are first-order; morph modes blend types)
+inline Filter2Type mode_filter2_type(int mode)
+{
+    static const Filter2Type types[NUM_MODES] = {
+        F2_LP, F2_LP, F2_LP,
+        F2_HP, F2_HP, F2_HP,
+        F2_BP, F2_BP,
+        F2_NOTCH, F2_NOTCH,
+        F2_AP, F2_AP,
+        F2_LP, F2_LP
+    };
+    return types[mode];
+}
+
+// Second-order modes with two cascaded stages (24dB and "+" modes)
+inline bool mode_is_cascade(int mode)
+{
+    return mode == 2 || mode == 5 || mode == 7 || mode == 9 || mode == 11 || mode == MODE_MORPH_CASCADE;
+}
+
+inline bool mode_is_morph(int mode)
+{
+    return mode == MODE_MORPH || mode == MODE_MORPH_CASCADE;
+}
+
+// Reset filter state when the mode changes
+inline void engine_update_mode(EngineState& state, int mode)
+{
+    if (mode != state.lastMode) {
+        state.f1.reset();
+        state.f2a.reset();
+        state.f2b.reset();
+        state.lastMode = mode;
+    }
+}
+
+// Compute filter coefficients for the current mode, cutoff, damping and morph
+inline void engine_configure(EngineState& state, const EngineParams& params, float sampleRate)
+{
+    switch (params.mode) {
+    case 0:
+        filter1_configure_lp(state.f1, sampleRate, params.cutoff);
+        break;
+    case 3:
+        filter1_configure_hp(state.f1, sampleRate, params.cutoff);
+        break;
+    default:
+        if (mode_is_morph(params.mode))
+            state.morphZ0 = filter2_configure_morph(state.f2a, sampleRate, params.cutoff,
+                                                    params.damping, params.morph);
+        else
+            filter2_configure(state.f2a, sampleRate, params.cutoff, params.damping,
+                              mode_filter2_type(params.mode));
+        if (mode_is_cascade(params.mode)) {
+            state.f2b.b0 = state.f2a.b0;
+            state.f2b.b1 = state.f2a.b1;
+            state.f2b.b2 = state.f2a.b2;
+            state.f2b.b3 = state.f2a.b3;
+        }
+        break;
+    }
+}
+
+// Drive + filter one sample with the current coefficients
+inline float engine_tick(EngineState& state, const EngineParams& params, float input)
+{
+    // --- Drive stage ---
+    float signal = input;
+    if (params.drive > 0.0f) {
+        float driveGain = 1.0f + params.drive * 9.0f;
+        signal = soft_clip(signal * driveGain);
+    }
+
+    // --- Filter ---
+    float wet;
+    if (params.mode == 0) {
+        wet = state.f1.process_lp(signal);
+    }
+    else if (params.mode == 3) {
+        wet = state.f1.process_hp(signal);
+    }
+    else if (mode_is_morph(params.mode)) {
+        wet = filter2_process_morph(state.f2a, signal, state.morphZ0);
+        if (params.mode == MODE_MORPH_CASCADE)
+            wet = filter2_process_morph(state.f2b, wet, state.morphZ0);
+    }
+    else {
+        Filter2Type type = mode_filter2_type(params.mode);
+        wet = filter2_process(state.f2a, signal, type);
+        if (mode_is_cascade(params.mode))
+            wet = filter2_process(state.f2b, wet, type);
+    }
+
+    // Flush denormals
+    state.f1.z = flush_denormal(state.f1.z);
+    state.f2a.z0 = flush_denormal(state.f2a.z0);
+    state.f2a.z1 = flush_denormal(state.f2a.z1);
+    state.f2b.z0 = flush_denormal(state.f2b.z0);
+    state.f2b.z1 = flush_denormal(state.f2b.z1);
+
+    return wet;
+}
+
+inline void engine_read_coefs(const EngineState& state, float c[NUM_COEFS])
+{
+    c[0] = state.f1.b0;  c[1] = state.f1.b1;
+    c[2] = state.f2a.b0; c[3] = state.f2a.b1; c[4] = state.f2a.b2; c[5] = state.f2a.b3;
+    c[6] = state.f2b.b0; c[7] = state.f2b.b1; c[8] = state.f2b.b2; c[9] = state.f2b.b3;
+    c[10] = state.morphZ0;
+}
+
+inline void engine_write_coefs(EngineState& state, const float c[NUM_COEFS])
+{
+    state.f1.b0 = c[0];  state.f1.b1 = c[1];
+    state.f2a.b0 = c[2]; state.f2a.b1 = c[3]; state.f2a.b2 = c[4]; state.f2a.b3 = c[5];
+    state.f2b.b0 = c[6]; state.f2b.b1 = c[7]; state.f2b.b2 = c[8]; state.f2b.b3 = c[9];
+    state.morphZ0 = c[10];
+}
+
+// Cutoff swept by the follower envelope (exponential, +/- FOLLOW_OCTAVES at full scale)
+inline float follow_cutoff(float cutoff, float env, float amount)
+{
+    float hz = cutoff * exp2f(amount * FOLLOW_OCTAVES * env);
+    if (hz < 20.0f) hz = 20.0f;
+    if (hz > 20000.0f) hz = 20000.0f;
+    return hz;
+}
+
+// Control-rate update while following: compute the coefficients for the
+// follower-swept cutoff and ramp toward them over the next controlDivision samples.
+// A mode change jumps straight to the new coefficients.
+inline void engine_follow_update(EngineState& state, const EngineParams& params, float sampleRate, float env)
+{
+    int n = params.controlDivision > 0 ? params.controlDivision : 1;
+    state.controlCounter = n;
+
+    EngineParams swept = params;
+    swept.cutoff = follow_cutoff(params.cutoff, env, params.followAmount);
+
+    bool modeChanged = params.mode != state.lastMode;
+    engine_update_mode(state, params.mode);
+
+    float from[NUM_COEFS];
+    engine_read_coefs(state, from);
+    engine_configure(state, swept, sampleRate);
+    if (modeChanged) {
+        for (int i = 0; i < NUM_COEFS; i++)
+            state.coefStep[i] = 0.0f;
+        return;
+    }
+
+    float to[NUM_COEFS];
+    engine_read_coefs(state, to);
+    float inv = 1.0f / (float)n;
+    for (int i = 0; i < NUM_COEFS; i++)
+        state.coefStep[i] = (to[i] - from[i]) * inv;
+    engine_write_coefs(state, from);
+}
+
+// Process one sample with the envelope follower driving cutoff.
+// The follower runs every sample; coefficients are computed every
+// controlDivision samples and linearly interpolated in between, or every
+// sample when controlDivision is 1 so audio-rate cutoff modulation survives.
+inline float engine_process_follow(EngineState& state, const EngineParams& params, float sampleRate, float input)
+{
+    if (params.controlDivision <= 1) {
+        state.follower.configure(sampleRate, params.followAttack, params.followRelease);
+        float env = state.follower.process(input);
+        state.follower.env = flush_denormal(state.follower.env);
+
+        EngineParams swept = params;
+        swept.cutoff = follow_cutoff(params.cutoff, env, params.followAmount);
+        state.controlCounter = 0;
+        engine_update_mode(state, params.mode);
+        engine_configure(state, swept, sampleRate);
+        return engine_tick(state, params, input);
+    }
+
+    bool update = state.controlCounter <= 0 || params.mode != state.lastMode;
+    if (update)
+        state.follower.configure(sampleRate, params.followAttack, params.followRelease);
+
+    float env = state.follower.process(input);
+    state.follower.env = flush_denormal(state.follower.env);
+
+    if (update)
+        engine_follow_update(state, params, sampleRate, env);
+    state.controlCounter--;
+
+    float wet = engine_tick(state, params, input);
+
+    float c[NUM_COEFS];
+    engine_read_coefs(state, c);
+    for (int i = 0; i < NUM_COEFS; i++)
+        c[i] += state.coefStep[i];
+    engine_write_coefs(state, c);
+    return wet;
+}
+
+// Process one sample (input and output normalized to ~+/-1).
+// Coefficients are recomputed every sample for audio-rate modulation,
+// or at control rate while the envelope follower is active.
+inline float engine_process(EngineState& state, const EngineParams& params, float sampleRate, float input)
+{
+    if (params.followAmount != 0.0f)
+        return engine_process_follow(state, params, sampleRate, input);
+
+    state.controlCounter = 0;
+    engine_update_mode(state, params.mode);
+    engine_configure(state, params, sampleRate);
+    return engine_tick(state, params, input);
+}
+
+// Render a block of samples, applying queued parameter events at their exact
+// sample offsets. Coefficients are only recomputed when an event changes
+// mode, cutoff, damping or morph (or at control rate while following).
+// Applied events persist in params.
+template <int Capacity>
+inline void engine_process_block(EngineState& state, EngineParams& params, float sampleRate,
+                                 const float* in, float* out, int frames,
+                                 wintoid::ParamEventQueue<Capacity>& events)
+{
+    bool dirty = true;
+
+    wintoid::render_with_events(events, frames,
+        [&](const wintoid::ParamEvent& e) {
+            if (apply_param_event(params, e.paramId, e.value))
+                dirty = true;
+        },
+        [&](int start, int count) {
+            if (params.followAmount != 0.0f) {
+                for (int i = start; i < start + count; i++)
+                    out[i] = engine_process_follow(state, params, sampleRate, in[i]);
+                dirty = true;   // reconfigure if following stops
+                return;
+            }
+            if (dirty) {
+                state.controlCounter = 0;
+                engine_update_mode(state, params.mode);
+                engine_configure(state, params, sampleRate);
+                dirty = false;
+            }
+            for (int i = start; i < start + count; i++)
+                out[i] = engine_tick(state, params, in[i]);
+        });
+}
+
+// ============================================================
+// Fixed internal rate
+// At host rates of 88.2kHz and above, drive + filter can run at
+// host / factor (44.1-88.2kHz) between a polyphase decimator and
+// interpolator. The filter's Sigma warping keeps cutoffs near the internal
+// Nyquist accurate, so nothing audible is lost below ~20kHz.
+// ============================================================
+
+// Largest integer factor that keeps the internal rate at or above 44.1kHz
+inline int fixed_rate_factor(float hostRate)
+{
+    int factor = (int)(hostRate / 44100.0f);
+    if (factor < 1) factor = 1;
+    if (factor > RESAMPLE_MAX_FACTOR) factor = RESAMPLE_MAX_FACTOR;
+    return factor;
+}
+
+struct FixedRateState
+{
+    PolyphaseResampler resampler;
+    float internalRate = 48000.0f;
+
+    bool active() const { return resampler.factor > 1; }
+
+    // Added delay in host samples (0 when inactive)
+    int latency() const { return resampler.latency(); }
+};
+
+// Choose the internal rate for a host rate. Resets the filter state when
+// the factor changes, since the state is only valid at one rate.
+inline void engine_configure_fixed_rate(EngineState& state, FixedRateState& fixed,
+                                        float hostRate, bool enabled)
+{
+    int factor = enabled ? fixed_rate_factor(hostRate) : 1;
+    if (factor != fixed.resampler.factor) {
+        fixed.resampler.design(factor);
+        state.lastMode = -1;
+    }
+    fixed.internalRate = hostRate / (float)factor;
+}
+
+// Process one host-rate sample. The engine runs once every `factor` calls,
+// at the internal rate; output is delayed by fixed.latency() samples.
+inline float engine_process_fixed_rate(EngineState& state, FixedRateState& fixed,
+                                       const EngineParams& params, float hostRate, float input)
+{
+    if (!fixed.active())
+        return engine_process(state, params, hostRate, input);
+
+    float x;
+    if (fixed.resampler.decimate(input, x))
+        fixed.resampler.interpolate_push(engine_process(state, params, fixed.internalRate, x));
+    return fixed.resampler.interpolate_pull();
+}
+
+} // namespace vortex
@@ -18,27 +18,35 @@ constexpr float ATTEN_X = 23.75f;
 
 // --- Cutoff group (knob → CV jack + trimpot) ---
 constexpr float CUTOFF_KNOB_X       = CENTER_X;
-constexpr float CUTOFF_KNOB_Y       = 32.0f;
+constexpr float CUTOFF_KNOB_Y       = 30.0f;
 constexpr float CV_CUTOFF_JACK_X    = CENTER_X;
-constexpr float CV_CUTOFF_JACK_Y    = 44.0f;
+constexpr float CV_CUTOFF_JACK_Y    = 40.0f;
 constexpr float CV_CUTOFF_ATTEN_X   = ATTEN_X;
-constexpr float CV_CUTOFF_ATTEN_Y   = 44.0f;
+constexpr float CV_CUTOFF_ATTEN_Y   = 40.0f;
 
 // --- Resonance group ---
 constexpr float RESONANCE_KNOB_X       = CENTER_X;
-constexpr float RESONANCE_KNOB_Y       = 60.0f;
+constexpr float RESONANCE_KNOB_Y       = 54.0f;
 constexpr float CV_RESONANCE_JACK_X    = CENTER_X;
-constexpr float CV_RESONANCE_JACK_Y    = 72.0f;
+constexpr float CV_RESONANCE_JACK_Y    = 64.0f;
 constexpr float CV_RESONANCE_ATTEN_X   = ATTEN_X;
-constexpr float CV_RESONANCE_ATTEN_Y   = 72.0f;
+constexpr float CV_RESONANCE_ATTEN_Y   = 64.0f;
 
 // --- Drive group ---
 constexpr float DRIVE_KNOB_X       = CENTER_X;
-constexpr float DRIVE_KNOB_Y       = 88.0f;
+constexpr float DRIVE_KNOB_Y       = 78.0f;
 constexpr float CV_DRIVE_JACK_X    = CENTER_X;
-constexpr float CV_DRIVE_JACK_Y    = 100.0f;
+constexpr float CV_DRIVE_JACK_Y    = 88.0f;
 constexpr float CV_DRIVE_ATTEN_X   = ATTEN_X;
-constexpr float CV_DRIVE_ATTEN_Y   = 100.0f;
+constexpr float CV_DRIVE_ATTEN_Y   = 88.0f;
+
+// --- Morph group (knob, CV jack and trimpot on one row) ---
+constexpr float MORPH_KNOB_X       = 6.5f;
+constexpr float MORPH_KNOB_Y       = 101.0f;
+constexpr float CV_MORPH_JACK_X    = CENTER_X;
+constexpr float CV_MORPH_JACK_Y    = 101.0f;
+constexpr float CV_MORPH_ATTEN_X   = ATTEN_X;
+constexpr float CV_MORPH_ATTEN_Y   = 101.0f;
 
 // Audio I/O (same height as FB row on Four)
 constexpr float AUDIO_IN_X  = 9.0f;
@@ -0,0 +1,113 @@
+#pragma once
+
+// Vortex panel parameter ids (as saved in Rack patches) and the mapping from
+// panel values to engine params. Vortex.cpp static_asserts that its ParamId
+// enum matches and maps its values through the same helpers, so saved
+// patches render offline (with no cables patched) as the module plays them.
+// No VCV Rack API dependencies — testable on desktop.
+
+#include "engine.h"
+
+namespace vortex {
+
+enum PanelParamId
+{
+    PANEL_MODE = 0,
+    PANEL_CUTOFF,
+    PANEL_RESONANCE,
+    PANEL_DRIVE,
+    PANEL_CUTOFF_CV_ATTEN,
+    PANEL_RESONANCE_CV_ATTEN,
+    PANEL_DRIVE_CV_ATTEN,
+    PANEL_MORPH,
+    PANEL_MORPH_CV_ATTEN,
+    PANEL_FIXED_RATE,
+    PANEL_FOLLOW_AMOUNT,
+    PANEL_FOLLOW_ATTACK,
+    PANEL_FOLLOW_RELEASE,
+    PANEL_FOLLOW_RATE,
+    PANEL_PARAMS_LEN
+};
+
+// configParam defaults (for params missing from a patch)
+inline void panel_defaults(float values[PANEL_PARAMS_LEN])
+{
+    for (int id = 0; id < PANEL_PARAMS_LEN; id++)
+        values[id] = 0.0f;
+    values[PANEL_CUTOFF] = 1000.0f;
+    values[PANEL_FOLLOW_ATTACK] = log2f(0.005f);
+    values[PANEL_FOLLOW_RELEASE] = log2f(0.1f);
+    values[PANEL_FOLLOW_RATE] = 1.0f;
+}
+
+// --- Panel value -> engine value mapping ---
+// Shared by Vortex::process and panel_engine_params, so offline renders
+// follow the module. CV arguments are in volts (0 when unpatched).
+
+// Cutoff knob (Hz) with attenuated 1V/oct CV
+inline float panel_cutoff(float knob, float cv, float atten)
+{
+    float hz = knob;
+    if (cv != 0.0f)
+        hz *= voct_to_mult(cv * atten);
+    return hz < 20.0f ? 20.0f : (hz > 20000.0f ? 20000.0f : hz);
+}
+
+// Resonance knob 0-1 -> damping 0.707-0.01; 5V of CV sweeps the full range
+inline float panel_damping(float reso, float cv, float atten)
+{
+    float damping = 0.707f * (1.0f - reso) + 0.01f * reso - cv * atten * 0.2f;
+    return damping < 0.01f ? 0.01f : (damping > 0.707f ? 0.707f : damping);
+}
+
+// Drive knob 0-1 with attenuated CV (10V = full range)
+inline float panel_drive(float knob, float cv, float atten)
+{
+    float drive = knob + cv * atten / 10.0f;
+    return drive < 0.0f ? 0.0f : (drive > 1.0f ? 1.0f : drive);
+}
+
+// Morph knob 0-4; 10V sweeps the full LP > BP > HP > Notch > AP range
+inline float panel_morph(float knob, float cv, float atten)
+{
+    float morph = knob + cv * atten * 0.4f;
+    return morph < 0.0f ? 0.0f : (morph > 4.0f ? 4.0f : morph);
+}
+
+// Follower attack/release param (log2 seconds) -> seconds
+inline float panel_follow_time(float value)
+{
+    return exp2f(value);
+}
+
+// Follower update menu index (0-3) -> samples per coefficient update
+inline int panel_control_division(float rate)
+{
+    int index = (int)rate;
+    return 8 << (index < 0 ? 0 : (index > 3 ? 3 : index));
+}
+
+// Engine params for the panel settings with no CV
+inline EngineParams panel_engine_params(const float values[PANEL_PARAMS_LEN])
+{
+    EngineParams ep;
+    int mode = (int)values[PANEL_MODE];
+    ep.mode = mode < 0 ? 0 : (mode >= NUM_MODES ? NUM_MODES - 1 : mode);
+    ep.cutoff = panel_cutoff(values[PANEL_CUTOFF], 0.0f, values[PANEL_CUTOFF_CV_ATTEN]);
+    ep.damping = panel_damping(values[PANEL_RESONANCE], 0.0f, values[PANEL_RESONANCE_CV_ATTEN]);
+    ep.drive = panel_drive(values[PANEL_DRIVE], 0.0f, values[PANEL_DRIVE_CV_ATTEN]);
+    ep.morph = panel_morph(values[PANEL_MORPH], 0.0f, values[PANEL_MORPH_CV_ATTEN]);
+
+    ep.followAmount = values[PANEL_FOLLOW_AMOUNT];
+    ep.followAttack = panel_follow_time(values[PANEL_FOLLOW_ATTACK]);
+    ep.followRelease = panel_follow_time(values[PANEL_FOLLOW_RELEASE]);
+    ep.controlDivision = panel_control_division(values[PANEL_FOLLOW_RATE]);
+    return ep;
+}
+
+inline bool panel_fixed_rate(const float values[PANEL_PARAMS_LEN])
+{
+    return values[PANEL_FIXED_RATE] > 0.5f;
+}
+
+} // namespace vortex
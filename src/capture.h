@@ -0,0 +1,358 @@
+#ifndef WINTOID_CAPTURE_H
+#define WINTOID_CAPTURE_H
+
+// Record-and-replay capture of module input streams.
+// No VCV Rack API dependencies — testable on desktop.
+//
+// The audio thread pushes one frame (a fixed number of float channels) per
+// sample into a preallocated ring buffer. A background thread drains the
+// ring and writes a compact delta-encoded file:
+//
+//   header:  "WCAP", uint32 version, char[4] module tag, uint32 channels,
+//            float sampleRate
+//   records: varint skip       frames identical to the previous frame
+//            uint8 mask[]      ceil(channels / 8) bytes, bit set = changed
+//            float values[]    one per changed channel, in channel order
+//
+// The previous frame starts as all zeros. A record with an all-zero mask
+// ends the stream (its skip count still applies).
+//
+// Version 2: Four frames hold engine params after built-in modulation.
+// Version 1 Four frames did not, so they are refused rather than replayed
+// into different audio.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wintoid {
+
+static const uint32_t CAPTURE_VERSION = 2;
+
+struct CaptureHeader
+{
+    char tag[4] = { 0, 0, 0, 0 };   // module tag, e.g. "FOUR", "VRTX"
+    uint32_t channels = 0;
+    float sampleRate = 0.0f;
+};
+
+// --- Encoding helpers ---
+
+inline void capture_write_varint( FILE* f, uint32_t v )
+{
+    while ( v >= 0x80 )
+    {
+        fputc( (int)( ( v & 0x7F ) | 0x80 ), f );
+        v >>= 7;
+    }
+    fputc( (int)v, f );
+}
+
+inline bool capture_read_varint( FILE* f, uint32_t& v )
+{
+    v = 0;
+    for ( int shift = 0; shift < 35; shift += 7 )
+    {
+        int c = fgetc( f );
+        if ( c == EOF )
+            return false;
+        v |= (uint32_t)( c & 0x7F ) << shift;
+        if ( !( c & 0x80 ) )
+            return true;
+    }
+    return false;
+}
+
+// Delta encoder state shared by the writer thread
+struct CaptureEncoder
+{
+    std::vector<float> prev;
+    std::vector<uint8_t> mask;
+    uint32_t skip = 0;
+
+    void reset( int channels )
+    {
+        prev.assign( channels, 0.0f );
+        mask.assign( ( channels + 7 ) / 8, 0 );
+        skip = 0;
+    }
+
+    void encode( FILE* f, const float* frame )
+    {
+        int channels = (int)prev.size();
+        bool changed = false;
+        std::fill( mask.begin(), mask.end(), 0 );
+        for ( int c = 0; c < channels; c++ )
+        {
+            if ( memcmp( &frame[c], &prev[c], sizeof( float ) ) != 0 )
+            {
+                mask[c >> 3] |= (uint8_t)( 1 << ( c & 7 ) );
+                changed = true;
+            }
+        }
+
+        if ( !changed )
+        {
+            skip++;
+            return;
+        }
+
+        capture_write_varint( f, skip );
+        skip = 0;
+        fwrite( mask.data(), 1, mask.size(), f );
+        for ( int c = 0; c < channels; c++ )
+        {
+            if ( mask[c >> 3] & ( 1 << ( c & 7 ) ) )
+            {
+                fwrite( &frame[c], sizeof( float ), 1, f );
+                prev[c] = frame[c];
+            }
+        }
+    }
+
+    void finish( FILE* f )
+    {
+        capture_write_varint( f, skip );
+        skip = 0;
+        std::fill( mask.begin(), mask.end(), 0 );
+        fwrite( mask.data(), 1, mask.size(), f );
+    }
+};
+
+// --- Recorder (audio thread producer, background writer thread) ---
+
+struct CaptureRecorder
+{
+    // capacityFrames must be a power of two
+    CaptureRecorder( int channels, int capacityFrames )
+        : channels( channels ), capacity( capacityFrames )
+    {
+    }
+
+    ~CaptureRecorder()
+    {
+        stop();
+    }
+
+    // UI thread. Opens the file and starts the writer thread.
+    bool start( const std::string& path, const char tag[4], float sampleRate )
+    {
+        stop();
+
+        file = fopen( path.c_str(), "wb" );
+        if ( !file )
+            return false;
+
+        // Allocated once, on first use, so idle instances cost no memory
+        if ( ring.empty() )
+            ring.resize( (size_t)capacity * channels );
+
+        fwrite( "WCAP", 1, 4, file );
+        fwrite( &CAPTURE_VERSION, sizeof( uint32_t ), 1, file );
+        fwrite( tag, 1, 4, file );
+        uint32_t ch = (uint32_t)channels;
+        fwrite( &ch, sizeof( uint32_t ), 1, file );
+        fwrite( &sampleRate, sizeof( float ), 1, file );
+
+        encoder.reset( channels );
+        head.store( 0 );
+        tail.store( 0 );
+        dropped.store( 0 );
+        running.store( true );
+        writer = std::thread( &CaptureRecorder::writerLoop, this );
+        recording.store( true, std::memory_order_release );
+        return true;
+    }
+
+    // UI thread. Stops recording, flushes remaining frames and closes the file.
+    void stop()
+    {
+        recording.store( false, std::memory_order_release );
+        if ( writer.joinable() )
+        {
+            running.store( false );
+            writer.join();
+        }
+        if ( file )
+        {
+            drain();
+            encoder.finish( file );
+            fclose( file );
+            file = nullptr;
+        }
+    }
+
+    bool isRecording() const
+    {
+        return recording.load( std::memory_order_acquire );
+    }
+
+    // Audio thread. Copies one frame; drops it (returns false) if the writer
+    // has fallen behind.
+    bool record( const float* frame )
+    {
+        uint32_t t = tail.load( std::memory_order_relaxed );
+        if ( t - head.load( std::memory_order_acquire ) >= (uint32_t)capacity )
+        {
+            dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+        memcpy( &ring[(size_t)( t & ( capacity - 1 ) ) * channels], frame, sizeof( float ) * channels );
+        tail.store( t + 1, std::memory_order_release );
+        return true;
+    }
+
+    uint32_t droppedFrames() const
+    {
+        return dropped.load( std::memory_order_relaxed );
+    }
+
+    const int channels;
+    const int capacity;
+
+private:
+    void drain()
+    {
+        uint32_t h = head.load( std::memory_order_relaxed );
+        uint32_t t = tail.load( std::memory_order_acquire );
+        for ( ; h != t; h++ )
+            encoder.encode( file, &ring[(size_t)( h & ( capacity - 1 ) ) * channels] );
+        head.store( h, std::memory_order_release );
+    }
+
+    void writerLoop()
+    {
+        while ( running.load() )
+        {
+            drain();
+            std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        }
+    }
+
+    std::vector<float> ring;
+    std::atomic<uint32_t> head { 0 };
+    std::atomic<uint32_t> tail { 0 };
+    std::atomic<uint32_t> dropped { 0 };
+    std::atomic<bool> recording { false };
+    std::atomic<bool> running { false };
+    std::thread writer;
+    FILE* file = nullptr;
+    CaptureEncoder encoder;
+};
+
+// --- Reader (replay) ---
+
+struct CaptureReader
+{
+    ~CaptureReader()
+    {
+        close();
+    }
+
+    bool open( const std::string& path )
+    {
+        close();
+        file = fopen( path.c_str(), "rb" );
+        if ( !file )
+            return false;
+
+        char magic[4];
+        uint32_t version = 0;
+        if ( fread( magic, 1, 4, file ) != 4 || memcmp( magic, "WCAP", 4 ) != 0
+             || fread( &version, sizeof( uint32_t ), 1, file ) != 1 || version != CAPTURE_VERSION
+             || fread( header.tag, 1, 4, file ) != 4
+             || fread( &header.channels, sizeof( uint32_t ), 1, file ) != 1
+             || fread( &header.sampleRate, sizeof( float ), 1, file ) != 1
+             || header.channels == 0 )
+        {
+            close();
+            return false;
+        }
+
+        frame.assign( header.channels, 0.0f );
+        mask.assign( ( header.channels + 7 ) / 8, 0 );
+        pendingSkip = 0;
+        pendingFrame = false;
+        finished = false;
+        return true;
+    }
+
+    void close()
+    {
+        if ( file )
+        {
+            fclose( file );
+            file = nullptr;
+        }
+    }
+
+    // Decode the next frame. Returns nullptr at end of stream.
+    const float* next()
+    {
+        if ( pendingSkip > 0 )
+        {
+            pendingSkip--;
+            return frame.data();
+        }
+        if ( pendingFrame )
+        {
+            pendingFrame = false;
+            for ( uint32_t c = 0; c < header.channels; c++ )
+                if ( mask[c >> 3] & ( 1 << ( c & 7 ) ) )
+                    frame[c] = values[c];
+            return frame.data();
+        }
+        if ( finished || !file )
+            return nullptr;
+
+        // Read the next record: skip count, then the changed frame
+        uint32_t skip;
+        if ( !capture_read_varint( file, skip )
+             || fread( mask.data(), 1, mask.size(), file ) != mask.size() )
+        {
+            finished = true;
+            return nullptr;
+        }
+
+        bool any = false;
+        values.resize( header.channels );
+        for ( uint32_t c = 0; c < header.channels; c++ )
+        {
+            if ( mask[c >> 3] & ( 1 << ( c & 7 ) ) )
+            {
+                any = true;
+                if ( fread( &values[c], sizeof( float ), 1, file ) != 1 )
+                {
+                    finished = true;
+                    return nullptr;
+                }
+            }
+        }
+
+        finished = !any;
+        pendingFrame = any;
+        pendingSkip = skip;
+        return next();
+    }
+
+    CaptureHeader header;
+
+private:
+    FILE* file = nullptr;
+    std::vector<float> frame;
+    std::vector<float> values;
+    std::vector<uint8_t> mask;
+    uint32_t pendingSkip = 0;
+    bool pendingFrame = false;
+    bool finished = false;
+};
+
+} // namespace wintoid
+
+#endif // WINTOID_CAPTURE_H
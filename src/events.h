@@ -0,0 +1,102 @@
+#ifndef WINTOID_EVENTS_H
+#define WINTOID_EVENTS_H
+
+// Timestamped parameter events for sample-accurate block rendering.
+// No VCV Rack API dependencies — testable on desktop.
+
+#include <atomic>
+#include <stdint.h>
+
+namespace wintoid {
+
+struct ParamEvent
+{
+    int offset;     // sample offset from the start of the block being rendered
+    int paramId;    // engine-specific parameter id (four::EngineParamId, vortex::EngineParamId)
+    float value;
+};
+
+// Single-producer / single-consumer lock-free event queue.
+// Storage is preallocated; push() returns false when the queue is full.
+// Events must be pushed in non-decreasing offset order, and offsets are
+// relative to the block in which they are consumed.
+template <int Capacity>
+struct ParamEventQueue
+{
+    static_assert( Capacity > 0 && ( Capacity & ( Capacity - 1 ) ) == 0,
+                   "ParamEventQueue capacity must be a power of two" );
+
+    ParamEvent events[Capacity];
+    std::atomic<uint32_t> head { 0 };   // next slot to read (consumer)
+    std::atomic<uint32_t> tail { 0 };   // next slot to write (producer)
+
+    // Producer side
+    bool push( int offset, int paramId, float value )
+    {
+        uint32_t t = tail.load( std::memory_order_relaxed );
+        if ( t - head.load( std::memory_order_acquire ) >= (uint32_t)Capacity )
+            return false;
+        ParamEvent& e = events[t & ( Capacity - 1 )];
+        e.offset = offset;
+        e.paramId = paramId;
+        e.value = value;
+        tail.store( t + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer side: next pending event, or nullptr if empty
+    const ParamEvent* peek() const
+    {
+        uint32_t h = head.load( std::memory_order_relaxed );
+        if ( h == tail.load( std::memory_order_acquire ) )
+            return nullptr;
+        return &events[h & ( Capacity - 1 )];
+    }
+
+    void pop()
+    {
+        head.store( head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    }
+
+    // Consumer side: drop all pending events
+    void clear()
+    {
+        head.store( tail.load( std::memory_order_acquire ), std::memory_order_release );
+    }
+
+    int size() const
+    {
+        return (int)( tail.load( std::memory_order_acquire ) - head.load( std::memory_order_acquire ) );
+    }
+};
+
+// Split a block of `frames` samples at event boundaries.
+// apply( const ParamEvent& ) is called for each event before the sample it
+// lands on; render( start, count ) is called for each event-free segment.
+// Events at or beyond `frames` stay queued for the caller.
+template <int Capacity, typename Apply, typename Render>
+inline void render_with_events( ParamEventQueue<Capacity>& queue, int frames, Apply apply, Render render )
+{
+    int pos = 0;
+    while ( pos < frames )
+    {
+        const ParamEvent* e;
+        while ( ( e = queue.peek() ) != nullptr && e->offset <= pos )
+        {
+            apply( *e );
+            queue.pop();
+        }
+
+        int end = frames;
+        e = queue.peek();
+        if ( e != nullptr && e->offset < end )
+            end = e->offset;
+
+        render( pos, end - pos );
+        pos = end;
+    }
+}
+
+} // namespace wintoid
+
+#endif // WINTOID_EVENTS_H
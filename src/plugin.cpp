@@ -7,3 +7,11 @@ void init(Plugin* p) {
     p->addModel(modelFour);
     p->addModel(modelVortex);
 }
+
+std::string capturePath(const std::string& prefix, int64_t moduleId) {
+    std::string dir = asset::user("wintoid/captures");
+    system::createDirectories(dir);
+    // Module id keeps instances that start in the same second apart
+    return system::join(dir, prefix + "-" + std::to_string((long long)moduleId) + "-"
+                        + std::to_string((long long)system::getUnixTime()) + ".wcap");
+}
@@ -7,3 +7,14 @@ extern Plugin* pluginInstance;
 
 extern Model* modelFour;
 extern Model* modelVortex;
+
+// Path for a new input capture file (see capture.h), in the user folder
+std::string capturePath(const std::string& prefix, int64_t moduleId);
+
+// Context-menu slider for a hidden param
+struct ParamSlider : ui::Slider {
+    ParamSlider(ParamQuantity* pq) {
+        quantity = pq;
+        box.size.x = 220.f;
+    }
+};
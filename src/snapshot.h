@@ -0,0 +1,67 @@
+#ifndef WINTOID_SNAPSHOT_H
+#define WINTOID_SNAPSHOT_H
+
+// Versioned parameter snapshots from the UI thread to the audio thread.
+// No VCV Rack API dependencies — testable on desktop.
+
+#include <atomic>
+#include <stdint.h>
+
+namespace wintoid {
+
+// Lock-free triple buffer with a version counter.
+// One writer publishes whole snapshots; one reader takes the newest one.
+// Each side owns one slot (writer: back, reader: front) and the third
+// (middle) is handed over through a single atomic exchange, so neither side
+// ever touches a slot the other is using and the reader never retries.
+//
+// Ordering: the writer fills its back slot, then swaps it into the middle
+// with a release exchange, so the filled slot is visible to whoever acquires
+// that index. The reader swaps its front slot for the middle with an acquire
+// exchange before copying, and the same exchange releases its earlier reads
+// of the old front, so the writer cannot get that slot back until the reader
+// is done with it. A publish that lands mid-copy only swaps the middle slot,
+// never the one being copied; the reader picks it up on its next poll.
+template <typename T>
+struct SnapshotBuffer
+{
+    static const uint32_t FRESH = 4;    // middle slot holds an unread snapshot
+
+    struct Slot
+    {
+        T value;
+        uint32_t version = 0;
+    };
+
+    Slot slots[3];
+    std::atomic<uint32_t> middle { 1 };    // slot index, plus FRESH
+    uint32_t back = 2;          // writer only
+    uint32_t front = 0;         // reader only
+    uint32_t published = 0;     // writer only
+
+    // Writer side
+    void publish( const T& value )
+    {
+        slots[back].value = value;
+        slots[back].version = ++published;
+        back = middle.exchange( back | FRESH, std::memory_order_acq_rel ) & ~FRESH;
+    }
+
+    // Reader side. Returns true and fills `out` if a snapshot newer than
+    // `seen` is available; `seen` is updated to its version.
+    bool poll( uint32_t& seen, T& out )
+    {
+        if ( !( middle.load( std::memory_order_relaxed ) & FRESH ) )
+            return false;
+        front = middle.exchange( front, std::memory_order_acq_rel ) & ~FRESH;
+        if ( slots[front].version == seen )
+            return false;
+        out = slots[front].value;
+        seen = slots[front].version;
+        return true;
+    }
+};
+
+} // namespace wintoid
+
+#endif // WINTOID_SNAPSHOT_H
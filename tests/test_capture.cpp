@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+// Test macros (same pattern as four)
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) \
+    static void test_##name(); \
+    static void run_##name() { \
+        tests_run++; \
+        printf("  %s ... ", #name); \
+        test_##name(); \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+    static void test_##name()
+
+#define ASSERT(cond) \
+    do { if (!(cond)) { \
+        printf("FAIL\n    %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } } while(0)
+
+#define ASSERT_NEAR(a, b, eps) \
+    do { float _a=(a), _b=(b); if (fabsf(_a-_b) > (eps)) { \
+        printf("FAIL\n    %s:%d: %f != %f (eps=%f)\n", \
+               __FILE__, __LINE__, (double)_a, (double)_b, (double)(eps)); \
+        exit(1); \
+    } } while(0)
+
+
+#include "../src/capture.h"
+#include "../src/Four/engine.h"
+
+static const char* TMP_PATH = "test_capture.wcap";
+
+// --- Round trip ---
+
+TEST(round_trip_preserves_frames)
+{
+    const int CH = 10;
+    const int N = 5000;
+    wintoid::CaptureRecorder rec(CH, 1 << 13);
+    ASSERT(rec.start(TMP_PATH, "TEST", 48000.0f));
+    ASSERT(rec.isRecording());
+
+    float frame[CH];
+    for (int i = 0; i < N; i++) {
+        for (int c = 0; c < CH; c++)
+            frame[c] = (c == 0) ? sinf((float)i * 0.01f)   // audio-rate channel
+                     : (float)((i / 1000) * c);            // stepped "param" channels
+        rec.record(frame);
+    }
+    rec.stop();
+    ASSERT(!rec.isRecording());
+    ASSERT(rec.droppedFrames() == 0);
+
+    wintoid::CaptureReader reader;
+    ASSERT(reader.open(TMP_PATH));
+    ASSERT(memcmp(reader.header.tag, "TEST", 4) == 0);
+    ASSERT(reader.header.channels == (uint32_t)CH);
+    ASSERT_NEAR(reader.header.sampleRate, 48000.0f, 1e-3f);
+
+    int n = 0;
+    const float* f;
+    while ((f = reader.next()) != nullptr) {
+        ASSERT_NEAR(f[0], sinf((float)n * 0.01f), 0.0f);
+        for (int c = 1; c < CH; c++)
+            ASSERT_NEAR(f[c], (float)((n / 1000) * c), 0.0f);
+        n++;
+    }
+    ASSERT(n == N);
+    remove(TMP_PATH);
+}
+
+TEST(constant_frames_are_compact)
+{
+    const int CH = 41;
+    wintoid::CaptureRecorder rec(CH, 1 << 12);
+    ASSERT(rec.start(TMP_PATH, "TEST", 48000.0f));
+    float frame[CH];
+    for (int c = 0; c < CH; c++) frame[c] = 0.5f;
+    for (int i = 0; i < 48000; i++)
+        while (!rec.record(frame))   // ring smaller than the capture: wait for the writer
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    rec.stop();
+
+    FILE* f = fopen(TMP_PATH, "rb");
+    ASSERT(f != nullptr);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    ASSERT(size < 256);   // one full frame plus skip counts, not 48000 frames
+
+    wintoid::CaptureReader reader;
+    ASSERT(reader.open(TMP_PATH));
+    int n = 0;
+    while (reader.next()) n++;
+    ASSERT(n == 48000);
+    remove(TMP_PATH);
+}
+
+TEST(trailing_identical_frames_survive)
+{
+    wintoid::CaptureRecorder rec(2, 1 << 8);
+    ASSERT(rec.start(TMP_PATH, "TEST", 44100.0f));
+    float a[2] = { 1.0f, 2.0f };
+    float zero[2] = { 0.0f, 0.0f };
+    rec.record(zero);   // identical to the implicit initial frame
+    rec.record(a);
+    rec.record(a);
+    rec.record(a);
+    rec.stop();
+
+    wintoid::CaptureReader reader;
+    ASSERT(reader.open(TMP_PATH));
+    const float* f = reader.next();
+    ASSERT(f && f[0] == 0.0f);
+    for (int i = 0; i < 3; i++) {
+        f = reader.next();
+        ASSERT(f && f[0] == 1.0f && f[1] == 2.0f);
+    }
+    ASSERT(reader.next() == nullptr);
+    remove(TMP_PATH);
+}
+
+TEST(reader_rejects_garbage)
+{
+    FILE* f = fopen(TMP_PATH, "wb");
+    fputs("not a capture", f);
+    fclose(f);
+    wintoid::CaptureReader reader;
+    ASSERT(!reader.open(TMP_PATH));
+    remove(TMP_PATH);
+}
+
+TEST(reader_rejects_other_versions)
+{
+    // A version 1 header, otherwise valid
+    FILE* f = fopen(TMP_PATH, "wb");
+    uint32_t version = 1, channels = 2;
+    float rate = 48000.0f;
+    fwrite("WCAP", 1, 4, f);
+    fwrite(&version, sizeof(uint32_t), 1, f);
+    fwrite("FOUR", 1, 4, f);
+    fwrite(&channels, sizeof(uint32_t), 1, f);
+    fwrite(&rate, sizeof(float), 1, f);
+    fclose(f);
+    wintoid::CaptureReader reader;
+    ASSERT(!reader.open(TMP_PATH));
+    remove(TMP_PATH);
+}
+
+// --- Engine frame layout ---
+
+TEST(four_capture_frame_round_trips_params)
+{
+    four::EngineParams src;
+    src.algorithm = 4;
+    src.modMaster = 0.3f;
+    src.opCoarse[2] = 3.5f;
+    src.opFoldType[3] = 2;
+    src.opFreqMode[1] = 1;
+
+    float frame[four::CAPTURE_CHANNELS];
+    four::engine_capture_frame(src, 0.25f, frame);
+    ASSERT_NEAR(frame[four::CAPTURE_EXT_PM], 0.25f, 0.0f);
+
+    four::EngineParams dst;
+    for (int id = 0; id < four::PARAM_COUNT; id++)
+        four::apply_param_event(dst, id, frame[id]);
+    ASSERT(dst.algorithm == 4);
+    ASSERT_NEAR(dst.modMaster, 0.3f, 0.0f);
+    ASSERT_NEAR(dst.opCoarse[2], 3.5f, 0.0f);
+    ASSERT(dst.opFoldType[3] == 2);
+    ASSERT(dst.opFreqMode[1] == 1);
+}
+
+TEST(four_modulated_capture_replays_exactly)
+{
+    // Same order as Four::process: modulation folded into the params, the
+    // frame captured, then the engine run on the captured values
+    const float sampleTime = 1.f / 48000.f;
+    four::EngineParams base;
+    base.modMaster = 0.7f;
+    base.algorithm = 2;
+    base.opLevel[1] = 0.5f;
+
+    four::ModParams mp;
+    mp.amount[four::MOD_SRC_LFO][four::MOD_LEVEL][1] = 0.5f;
+    mp.amount[four::MOD_SRC_ENV][four::MOD_FOLD][0] = 0.8f;
+    mp.lfoRate[1] = 5.f;
+    four::ModState ms;
+
+    four::EngineState live;
+    const int N = 4800;
+    static float frames[N][four::CAPTURE_CHANNELS];
+    static float liveOut[N];
+    for (int i = 0; i < N; i++) {
+        if (i % four::MOD_CONTROL_DIVISION == 0) {
+            float lfo[4], env[4], offset[four::NUM_MOD_TARGETS][4];
+            four::mod_sources_tick(ms, mp, sampleTime * four::MOD_CONTROL_DIVISION, i == 0, lfo, env);
+            four::mod_matrix(mp, lfo, env, offset);
+            four::engine_set_modulation(live, offset, four::MOD_CONTROL_DIVISION);
+        }
+        four::EngineParams ep = base;
+        if (live.mod.active)
+            four::engine_apply_modulation(live.mod, ep);
+        four::engine_capture_frame(ep, 0.f, frames[i]);
+        float freq[4];
+        four::engine_calc_frequencies(ep, freq);
+        liveOut[i] = four::engine_process_freq(live, ep, freq, sampleTime, 0.f);
+    }
+
+    // Replay: no modulation state, only the captured params
+    four::EngineState replay;
+    four::EngineParams rp;
+    bool moved = false;
+    for (int i = 0; i < N; i++) {
+        for (int id = 0; id < four::PARAM_COUNT; id++)
+            four::apply_param_event(rp, id, frames[i][id]);
+        moved = moved || rp.opLevel[1] != base.opLevel[1];
+        ASSERT_NEAR(four::engine_process(replay, rp, sampleTime, frames[i][four::CAPTURE_EXT_PM]), liveOut[i], 0.0f);
+    }
+    ASSERT(moved);   // the modulation really reached the captured params
+}
+
+int main()
+{
+    printf("Capture Tests\n");
+    printf("=============\n\n");
+
+    run_round_trip_preserves_frames();
+    run_constant_frames_are_compact();
+    run_trailing_identical_frames_survive();
+    run_reader_rejects_garbage();
+    run_reader_rejects_other_versions();
+    run_four_capture_frame_round_trips_params();
+    run_four_modulated_capture_replays_exactly();
+
+    printf("\n%d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
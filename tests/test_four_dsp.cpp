@@ -411,6 +411,24 @@ TEST(dc_blocker_passes_ac)
     ASSERT( maxOut > 0.9f );
 }
 
+TEST(dc_blocker_corner_tracks_sample_rate)
+{
+    // setCutoff at 48kHz reproduces the original pole
+    four::DCBlocker dc48, dc96;
+    dc48.setCutoff( four::DC_BLOCKER_HZ, 48000.f );
+    ASSERT_NEAR( dc48.R, 0.999f, 1e-5f );
+
+    // Same corner at 96kHz: the step response decays equally in the same time
+    dc96.setCutoff( four::DC_BLOCKER_HZ, 96000.f );
+    float out48 = 0.f, out96 = 0.f;
+    for ( int i = 0; i < 4800; ++i )
+        out48 = dc48.process( 1.0f );
+    for ( int i = 0; i < 9600; ++i )
+        out96 = dc96.process( 1.0f );
+    ASSERT_NEAR( out48, out96, 0.002f );
+    ASSERT( out48 < 0.9f );
+}
+
 // --- flush_denormal ---
 
 TEST(flush_denormal_zero)
@@ -554,6 +572,22 @@ TEST(coarse_fixed_from_param)
     ASSERT( four::coarse_fixed_from_param(32.0f) > four::coarse_fixed_from_param(16.0f) );
 }
 
+TEST(routed_matches_algorithm_table)
+{
+    // Precompiled routing weights must reproduce gather/sum for every algorithm
+    float opOut[4] = { 0.3f, -0.7f, 0.45f, 0.9f };
+    float level[4] = { 0.8f, 0.5f, 0.25f, 1.0f };
+    for ( int a = 0; a < 11; a++ )
+    {
+        const four::AlgorithmRouting& r = four::routingTable.algo[a];
+        for ( int dst = 0; dst < 4; dst++ )
+            ASSERT_NEAR( four::gather_modulation_routed( dst, opOut, level, 0.6f, r ),
+                         four::gather_modulation( dst, opOut, level, 0.6f, four::algorithms[a] ), 1e-7f );
+        ASSERT_NEAR( four::sum_carriers_routed( opOut, level, r ),
+                     four::sum_carriers( opOut, level, four::algorithms[a] ), 1e-7f );
+    }
+}
+
 // --- Runner ---
 
 int main()
@@ -598,6 +632,7 @@ int main()
     run_polyblep_saw_reduces_aliasing();
     run_dc_blocker_removes_dc();
     run_dc_blocker_passes_ac();
+    run_dc_blocker_corner_tracks_sample_rate();
     run_flush_denormal_zero();
     run_flush_denormal_tiny();
     run_flush_denormal_normal();
@@ -614,6 +649,7 @@ int main()
     run_coarse_ratio_index_5();
     run_coarse_ratio_index_64();
     run_coarse_fixed_from_param();
+    run_routed_matches_algorithm_table();
 
     printf("\n%d/%d tests passed.\n", tests_passed, tests_run);
     return 0;
@@ -475,6 +475,397 @@ TEST(output_bounded)
     ASSERT( maxAbs < 10.f );
 }
 
+// --- Parameter events and block rendering ---
+
+TEST(event_queue_fifo_and_full)
+{
+    wintoid::ParamEventQueue<4> q;
+    ASSERT( q.peek() == nullptr );
+    ASSERT( q.push( 0, four::PARAM_MOD_MASTER, 0.1f ) );
+    ASSERT( q.push( 1, four::PARAM_MOD_MASTER, 0.2f ) );
+    ASSERT( q.push( 2, four::PARAM_MOD_MASTER, 0.3f ) );
+    ASSERT( q.push( 3, four::PARAM_MOD_MASTER, 0.4f ) );
+    ASSERT( !q.push( 4, four::PARAM_MOD_MASTER, 0.5f ) );   // full
+    ASSERT( q.size() == 4 );
+
+    ASSERT_NEAR( q.peek()->value, 0.1f, 1e-6f );
+    q.pop();
+    ASSERT_NEAR( q.peek()->value, 0.2f, 1e-6f );
+    q.clear();
+    ASSERT( q.peek() == nullptr );
+}
+
+TEST(block_without_events_matches_per_sample)
+{
+    four::EngineState stateA, stateB;
+    four::EngineParams params;
+    params.modMaster = 0.7f;
+    params.opLevel[1] = 0.5f;
+    params.opWarp[0] = 0.4f;
+    float sampleTime = 1.f / 48000.f;
+
+    float block[256];
+    wintoid::ParamEventQueue<16> events;
+    four::engine_process_block( stateB, params, sampleTime, nullptr, block, 256, events );
+
+    for ( int i = 0; i < 256; i++ )
+    {
+        float ref = four::engine_process( stateA, params, sampleTime, 0.f );
+        ASSERT_NEAR( block[i], ref, 1e-6f );
+    }
+}
+
+TEST(block_events_land_on_exact_sample)
+{
+    // Reference: rebuild params per sample, changing level at 100 and
+    // coarse (frequency) at 200.
+    four::EngineState stateA, stateB;
+    four::EngineParams paramsA, paramsB;
+    paramsA.modMaster = paramsB.modMaster = 0.5f;
+    paramsA.opLevel[1] = paramsB.opLevel[1] = 0.8f;
+    float sampleTime = 1.f / 48000.f;
+
+    float ref[300];
+    for ( int i = 0; i < 300; i++ )
+    {
+        if ( i == 100 ) paramsA.opLevel[1] = 0.2f;
+        if ( i == 200 ) paramsA.opCoarse[1] = 3.f;
+        ref[i] = four::engine_process( stateA, paramsA, sampleTime, 0.f );
+    }
+
+    wintoid::ParamEventQueue<16> events;
+    events.push( 100, four::PARAM_OP_LEVEL + 1, 0.2f );
+    events.push( 200, four::PARAM_OP_COARSE + 1, 3.f );
+
+    float block[300];
+    four::engine_process_block( stateB, paramsB, sampleTime, nullptr, block, 300, events );
+
+    for ( int i = 0; i < 300; i++ )
+        ASSERT_NEAR( block[i], ref[i], 1e-6f );
+
+    ASSERT( events.peek() == nullptr );
+    ASSERT_NEAR( paramsB.opCoarse[1], 3.f, 1e-6f );
+}
+
+TEST(block_leaves_later_events_queued)
+{
+    four::EngineState state;
+    four::EngineParams params;
+    float block[64];
+    wintoid::ParamEventQueue<16> events;
+    events.push( 10, four::PARAM_GLOBAL_VCA, 0.5f );
+    events.push( 80, four::PARAM_GLOBAL_VCA, 0.f );
+
+    four::engine_process_block( state, params, 1.f / 48000.f, nullptr, block, 64, events );
+
+    ASSERT_NEAR( params.globalVCA, 0.5f, 1e-6f );
+    ASSERT( events.size() == 1 );
+}
+
+// --- Per-sample algorithm switching ---
+
+TEST(algorithm_switch_per_sample)
+{
+    // Switching algorithm every sample must match a separate engine held at
+    // each algorithm. Without feedback the operator phases do not depend on
+    // the routing, so only the DC blocker history differs; it is copied from
+    // the switching engine before each comparison.
+    four::EngineParams params;
+    params.modMaster = 0.8f;
+    for ( int op = 0; op < 4; op++ )
+    {
+        params.opLevel[op] = 0.6f;
+        params.opCoarse[op] = (float)( op + 1 );
+    }
+    float sampleTime = 1.f / 48000.f;
+
+    four::EngineState state;
+    four::EngineState fixedState[11];
+    four::EngineParams fixedParams[11];
+    for ( int a = 0; a < 11; a++ )
+    {
+        fixedParams[a] = params;
+        fixedParams[a].algorithm = a;
+    }
+
+    float maxAbs = 0.f;
+    float maxSpread = 0.f;
+    for ( int i = 0; i < 4800; i++ )
+    {
+        params.algorithm = i % 11;
+        fixedState[params.algorithm].dcBlocker = state.dcBlocker;
+
+        float ref[11];
+        for ( int a = 0; a < 11; a++ )
+            ref[a] = four::engine_process( fixedState[a], fixedParams[a], sampleTime, 0.f );
+
+        float out = four::engine_process( state, params, sampleTime, 0.f );
+        ASSERT_NEAR( out, ref[params.algorithm], 1e-6f );
+        if ( fabsf(out) > maxAbs ) maxAbs = fabsf(out);
+
+        float lo = ref[0], hi = ref[0];
+        for ( int a = 1; a < 11; a++ )
+        {
+            lo = fminf( lo, ref[a] );
+            hi = fmaxf( hi, ref[a] );
+        }
+        maxSpread = fmaxf( maxSpread, hi - lo );
+    }
+    ASSERT( maxAbs > 0.01f );
+    ASSERT( maxAbs < 10.f );
+    // The algorithms really differ, so a wrong selection would be caught
+    ASSERT( maxSpread > 0.1f );
+}
+
+TEST(algorithm_event_clamped)
+{
+    four::EngineParams params;
+    four::apply_param_event( params, four::PARAM_ALGORITHM, 25.f );
+    ASSERT( params.algorithm == 10 );
+    four::apply_param_event( params, four::PARAM_ALGORITHM, -1.f );
+    ASSERT( params.algorithm == 0 );
+}
+
+// --- Built-in modulation ---
+
+TEST(mod_lfo_completes_one_cycle)
+{
+    four::ModParams mp;
+    four::ModState ms;
+    mp.lfoRate[2] = 2.f;
+    float lfo[4], env[4];
+    // 2Hz for 0.5s in 0.01s ticks: back to phase 0
+    for ( int i = 0; i < 50; i++ )
+        four::mod_sources_tick( ms, mp, 0.01f, false, lfo, env );
+    ASSERT( fminf( ms.lfoPhase[2], 1.f - ms.lfoPhase[2] ) < 1e-4f );
+    ASSERT_NEAR( lfo[0], four::oscillator_sine( 0.5f ), 1e-4f );   // 1Hz default lane
+}
+
+TEST(mod_envelope_attack_then_decay)
+{
+    four::ModParams mp;
+    four::ModState ms;
+    for ( int op = 0; op < 4; op++ ) { mp.attack[op] = 0.1f; mp.decay[op] = 0.2f; }
+    float lfo[4], env[4];
+
+    four::mod_sources_tick( ms, mp, 0.01f, true, lfo, env );
+    ASSERT_NEAR( env[1], 0.1f, 1e-5f );
+    for ( int i = 0; i < 9; i++ )
+        four::mod_sources_tick( ms, mp, 0.01f, false, lfo, env );
+    ASSERT_NEAR( env[1], 1.f, 1e-5f );      // peak after 0.1s
+
+    for ( int i = 0; i < 10; i++ )
+        four::mod_sources_tick( ms, mp, 0.01f, false, lfo, env );
+    ASSERT_NEAR( env[1], 0.5f, 1e-4f );     // halfway down after 0.1s of decay
+    for ( int i = 0; i < 20; i++ )
+        four::mod_sources_tick( ms, mp, 0.01f, false, lfo, env );
+    ASSERT( env[1] == 0.f );
+}
+
+TEST(mod_matrix_routes_per_operator)
+{
+    four::ModParams mp;
+    mp.amount[four::MOD_SRC_LFO][four::MOD_WARP][0] = 0.5f;
+    mp.amount[four::MOD_SRC_ENV][four::MOD_WARP][0] = 0.25f;
+    mp.amount[four::MOD_SRC_ENV][four::MOD_FEEDBACK][3] = -1.f;
+    ASSERT( four::mod_params_active( mp ) );
+
+    float lfo[4] = { 1.f, 1.f, 1.f, 1.f };
+    float env[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+    float offset[four::NUM_MOD_TARGETS][4];
+    four::mod_matrix( mp, lfo, env, offset );
+    ASSERT_NEAR( offset[four::MOD_WARP][0], 0.625f, 1e-6f );
+    ASSERT_NEAR( offset[four::MOD_FEEDBACK][3], -0.5f, 1e-6f );
+    ASSERT( offset[four::MOD_LEVEL][0] == 0.f );
+    ASSERT( offset[four::MOD_WARP][1] == 0.f );
+}
+
+TEST(mod_ramp_interpolates_and_clamps)
+{
+    four::EngineState state;
+    float offset[four::NUM_MOD_TARGETS][4] = {};
+    offset[four::MOD_FOLD][1] = 0.8f;
+    offset[four::MOD_LEVEL][0] = -2.f;
+    four::engine_set_modulation( state, offset, 4 );
+    ASSERT( state.mod.active );
+
+    float expected[] = { 0.f, 0.2f, 0.4f, 0.6f, 0.8f, 0.8f };
+    for ( int i = 0; i < 6; i++ )
+    {
+        four::EngineParams p;
+        p.opFold[1] = 0.5f;
+        four::engine_apply_modulation( state.mod, p );
+        ASSERT_NEAR( p.opFold[1], fminf( 0.5f + expected[i], 1.f ), 1e-6f );
+        ASSERT( p.opLevel[0] >= 0.f );
+    }
+
+    // Back to zero: inactive after the ramp down
+    float zero[four::NUM_MOD_TARGETS][4] = {};
+    four::engine_set_modulation( state, zero, 4 );
+    for ( int i = 0; i < 4; i++ )
+    {
+        four::EngineParams p;
+        four::engine_apply_modulation( state.mod, p );
+    }
+    four::engine_set_modulation( state, zero, 4 );
+    ASSERT( !state.mod.active );
+}
+
+TEST(mod_block_matches_per_sample)
+{
+    four::EngineState stateA, stateB;
+    four::EngineParams params;
+    params.modMaster = 0.6f;
+    params.opLevel[1] = 0.5f;
+    float sampleTime = 1.f / 48000.f;
+
+    float offset[four::NUM_MOD_TARGETS][4] = {};
+    offset[four::MOD_WARP][0] = 0.7f;
+    offset[four::MOD_LEVEL][1] = 0.3f;
+    four::engine_set_modulation( stateA, offset, 64 );
+    four::engine_set_modulation( stateB, offset, 64 );
+
+    float block[128];
+    wintoid::ParamEventQueue<16> events;
+    four::engine_process_block( stateB, params, sampleTime, nullptr, block, 128, events );
+
+    four::EngineParams unmodulated = params;
+    four::EngineState stateC;
+    float diff = 0.f;
+    for ( int i = 0; i < 128; i++ )
+    {
+        float ref = four::engine_process( stateA, params, sampleTime, 0.f );
+        ASSERT_NEAR( block[i], ref, 1e-6f );
+        diff += fabsf( ref - four::engine_process( stateC, unmodulated, sampleTime, 0.f ) );
+    }
+    ASSERT( diff > 0.1f );  // modulation was actually applied
+}
+
+// --- Oversampling and alias guard ---
+
+TEST(single_rate_keeps_pitch)
+{
+    // 1x rendering: same zero-crossing count as the 2x sine test
+    four::EngineState state;
+    four::EngineParams params;
+    params.algorithm = 7;
+    params.oversample = 1;
+    params.opLevel[1] = params.opLevel[2] = params.opLevel[3] = 0.f;
+    float sampleTime = 1.f / 48000.f;
+
+    int zeroCrossings = 0;
+    float prev = 0.f;
+    for ( int i = 0; i < 48000; i++ )
+    {
+        float out = four::engine_process( state, params, sampleTime, 0.f );
+        if ( i > 100 && prev < 0.f && out >= 0.f ) zeroCrossings++;
+        prev = out;
+    }
+    ASSERT( zeroCrossings >= 259 );
+    ASSERT( zeroCrossings <= 264 );
+}
+
+TEST(alias_guard_carson_bandwidth)
+{
+    // Algo 1 (4->3->2->1): op 2 (index 1) at 1 kHz modulates op 1 at 440 Hz
+    four::EngineParams params;
+    params.modMaster = 1.f;
+    params.opLevel[1] = 0.1f;
+    params.opLevel[2] = params.opLevel[3] = 0.f;
+    float freq[4] = { 440.f, 1000.f, 0.f, 0.f };
+    float scale[4];
+
+    // Edge 440 + 2pi*0.1*1000 + 1000 ~= 2068 Hz fits under 24 kHz
+    four::alias_guard_scales( params, freq, 24000.f, scale );
+    ASSERT_NEAR( scale[0], 1.f, 1e-6f );
+
+    // Full depth: deviation 6283 Hz needs scaling to fit under 4 kHz
+    params.opLevel[1] = 1.f;
+    four::alias_guard_scales( params, freq, 4000.f, scale );
+    float deviation = four::TWO_PI * 1000.f;
+    ASSERT( scale[0] < 1.f );
+    ASSERT_NEAR( 440.f + scale[0] * deviation + 1000.f, 4000.f, 0.5f );
+
+    // Carrier plus modulator already past Nyquist: no modulation at all
+    freq[0] = 3500.f;
+    four::alias_guard_scales( params, freq, 4000.f, scale );
+    ASSERT_NEAR( scale[0], 0.f, 1e-6f );
+
+    // Operators without incoming modulation are never scaled
+    ASSERT_NEAR( scale[3], 1.f, 1e-6f );
+}
+
+TEST(alias_guard_transparent_when_under_nyquist)
+{
+    // Low note, moderate FM: guarded output is identical to unguarded
+    four::EngineState s0, s1;
+    four::EngineParams p0, p1;
+    p0.modMaster = 0.3f;
+    p0.opLevel[1] = 0.5f;
+    p0.opLevel[2] = p0.opLevel[3] = 0.f;
+    p1 = p0;
+    p1.aliasGuard = true;
+    float sampleTime = 1.f / 48000.f;
+
+    for ( int i = 0; i < 4800; i++ )
+    {
+        float a = four::engine_process( s0, p0, sampleTime, 0.f );
+        float b = four::engine_process( s1, p1, sampleTime, 0.f );
+        ASSERT( a == b );
+    }
+}
+
+TEST(alias_guard_limits_bright_notes)
+{
+    // High note at full depth: the guard ramps depth down within one update
+    // period and restores it when switched off. The limit is the host
+    // Nyquist at 1x and 2x alike, since the 2x decimator does not remove
+    // what lies between the two.
+    for ( int oversample = 1; oversample <= 2; oversample++ )
+    {
+        four::EngineState state;
+        four::EngineParams params;
+        params.oversample = oversample;
+        params.aliasGuard = true;
+        params.modMaster = 1.f;
+        params.baseFreq = 3000.f;
+        params.opCoarse[1] = 2.f;
+        params.opLevel[2] = params.opLevel[3] = 0.f;
+        float sampleTime = 1.f / 48000.f;
+
+        float freq[4];
+        four::engine_calc_frequencies( params, freq );
+        float expected[4];
+        four::alias_guard_scales( params, freq, 24000.f, expected );
+        ASSERT( expected[0] < 0.5f );
+
+        for ( int i = 0; i < four::ALIAS_GUARD_DIVISION; i++ )
+            four::engine_process( state, params, sampleTime, 0.f );
+        ASSERT_NEAR( state.guard.scale[0], expected[0], 1e-4f );
+        ASSERT_NEAR( state.guard.scale[1], 1.f, 1e-6f );
+
+        params.aliasGuard = false;
+        four::engine_process( state, params, sampleTime, 0.f );
+        ASSERT( state.guard.scale[0] == 1.f );
+    }
+}
+
+TEST(oversample_events_accept_old_captures)
+{
+    // Captures made before these ids existed hold 0 in their channels
+    four::EngineParams params;
+    four::apply_param_event( params, four::PARAM_OVERSAMPLE, 0.f );
+    four::apply_param_event( params, four::PARAM_ALIAS_GUARD, 0.f );
+    ASSERT( params.oversample == 2 );
+    ASSERT( !params.aliasGuard );
+
+    four::apply_param_event( params, four::PARAM_OVERSAMPLE, 1.f );
+    four::apply_param_event( params, four::PARAM_ALIAS_GUARD, 1.f );
+    ASSERT( params.oversample == 1 );
+    ASSERT( params.aliasGuard );
+    ASSERT_NEAR( four::engine_param_value( params, four::PARAM_OVERSAMPLE ), 1.f, 1e-6f );
+}
+
 int main()
 {
     printf("Engine tests:\n");
@@ -494,6 +885,22 @@ int main()
     run_fine_tune_shifts_pitch();
     run_dc_blocker_removes_offset();
     run_output_bounded();
+    run_event_queue_fifo_and_full();
+    run_block_without_events_matches_per_sample();
+    run_block_events_land_on_exact_sample();
+    run_block_leaves_later_events_queued();
+    run_algorithm_switch_per_sample();
+    run_algorithm_event_clamped();
+    run_mod_lfo_completes_one_cycle();
+    run_mod_envelope_attack_then_decay();
+    run_mod_matrix_routes_per_operator();
+    run_mod_ramp_interpolates_and_clamps();
+    run_mod_block_matches_per_sample();
+    run_single_rate_keeps_pitch();
+    run_alias_guard_carson_bandwidth();
+    run_alias_guard_transparent_when_under_nyquist();
+    run_alias_guard_limits_bright_notes();
+    run_oversample_events_accept_old_captures();
 
     printf("\n%d/%d engine tests passed.\n", tests_passed, tests_run);
     return tests_passed == tests_run ? 0 : 1;
@@ -330,6 +330,134 @@ TEST(filter2_reset)
     ASSERT_NEAR(f.z1, 0.0f, 1e-6f);
 }
 
+// --- Response morph ---
+
+TEST(filter2_morph_endpoints_match_types)
+{
+    // Integer morph positions must reproduce LP, BP, HP, Notch, AP exactly
+    const vortex::Filter2Type order[5] = {
+        vortex::F2_LP, vortex::F2_BP, vortex::F2_HP, vortex::F2_NOTCH, vortex::F2_AP };
+    for (int m = 0; m < 5; m++) {
+        vortex::Filter2 ref, mor;
+        vortex::filter2_configure(ref, 48000.0f, 700.0f, 0.3f, order[m]);
+        float z0Gain = vortex::filter2_configure_morph(mor, 48000.0f, 700.0f, 0.3f, (float)m);
+        for (int i = 0; i < 500; i++) {
+            float in = sinf(2.0f * vortex::PI * 523.0f * (float)i / 48000.0f);
+            float a = vortex::filter2_process(ref, in, order[m]);
+            float b = vortex::filter2_process_morph(mor, in, z0Gain);
+            ASSERT_NEAR(a, b, 1e-5f);
+        }
+    }
+}
+
+TEST(filter2_morph_sweep_is_continuous)
+{
+    // Sweeping the morph across its whole range must not click:
+    // sample-to-sample steps stay comparable to the input's own steps.
+    vortex::Filter2 f;
+    float prev = 0.0f;
+    float maxStep = 0.0f;
+    const int N = 48000;
+    for (int i = 0; i < N; i++) {
+        float morph = 4.0f * (float)i / (float)N;
+        float z0Gain = vortex::filter2_configure_morph(f, 48000.0f, 1000.0f, 0.5f, morph);
+        float in = sinf(2.0f * vortex::PI * 200.0f * (float)i / 48000.0f);
+        float out = vortex::filter2_process_morph(f, in, z0Gain);
+        if (i > 0 && fabsf(out - prev) > maxStep) maxStep = fabsf(out - prev);
+        prev = out;
+    }
+    ASSERT(maxStep < 0.1f);
+}
+
+TEST(filter2_morph_clamps_range)
+{
+    vortex::Filter2 a, b;
+    float ga = vortex::filter2_configure_morph(a, 48000.0f, 1000.0f, 0.707f, -2.0f);
+    float gb = vortex::filter2_configure_morph(b, 48000.0f, 1000.0f, 0.707f, 0.0f);
+    ASSERT_NEAR(a.b2, b.b2, 1e-7f);
+    ASSERT_NEAR(a.b3, b.b3, 1e-7f);
+    ASSERT_NEAR(ga, gb, 1e-7f);
+}
+
+// --- Envelope follower ---
+
+TEST(follower_attack_and_release_time_constants)
+{
+    vortex::EnvelopeFollower f;
+    f.configure(48000.0f, 0.01f, 0.1f);
+
+    // Step up: ~63% after one attack time constant
+    float env = 0.0f;
+    for (int i = 0; i < 480; i++)
+        env = f.process(1.0f);
+    ASSERT_NEAR(env, 1.0f - expf(-1.0f), 0.01f);
+
+    // Settle, then step down: ~37% after one release time constant
+    for (int i = 0; i < 48000; i++)
+        f.process(-1.0f);   // rectified
+    for (int i = 0; i < 4800; i++)
+        env = f.process(0.0f);
+    ASSERT_NEAR(env, expf(-1.0f), 0.01f);
+}
+
+// --- Polyphase resampler ---
+
+// Round trip through decimate + interpolate, as the engine uses it
+static float resample_round_trip(vortex::PolyphaseResampler& rs, float x)
+{
+    float d;
+    if (rs.decimate(x, d))
+        rs.interpolate_push(d);
+    return rs.interpolate_pull();
+}
+
+TEST(resampler_dc_gain_unity)
+{
+    for (int factor = 2; factor <= 4; factor++) {
+        vortex::PolyphaseResampler rs;
+        rs.design(factor);
+        float out = 0.0f;
+        for (int i = 0; i < 1000; i++)
+            out = resample_round_trip(rs, 1.0f);
+        ASSERT_NEAR(out, 1.0f, 1e-3f);
+    }
+}
+
+TEST(resampler_latency_matches_pulse_centroid)
+{
+    for (int factor = 2; factor <= 4; factor++) {
+        vortex::PolyphaseResampler rs;
+        rs.design(factor);
+        // Feed a slow raised-cosine pulse (well inside the passband) and
+        // measure how far its centroid moves
+        const int WIDTH = 64 * factor;
+        const int CENTER = 600;
+        float sum = 0.0f, weighted = 0.0f;
+        for (int i = 0; i < 2000; i++) {
+            float t = (float)(i - CENTER) / (float)WIDTH;
+            float x = (fabsf(t) < 1.0f) ? 0.5f + 0.5f * cosf(vortex::PI * t) : 0.0f;
+            float y = resample_round_trip(rs, x);
+            sum += y;
+            weighted += y * (float)i;
+        }
+        ASSERT_NEAR(weighted / sum - (float)CENTER, (float)rs.latency(), 0.05f);
+    }
+}
+
+TEST(resampler_attenuates_above_internal_nyquist)
+{
+    // 4x: 192kHz host, 48kHz internal. 40kHz should be removed.
+    vortex::PolyphaseResampler rs;
+    rs.design(4);
+    float maxOut = 0.0f;
+    for (int i = 0; i < 19200; i++) {
+        float x = sinf(2.0f * vortex::PI * 40000.0f * (float)i / 192000.0f);
+        float y = resample_round_trip(rs, x);
+        if (i > 1000 && fabsf(y) > maxOut) maxOut = fabsf(y);
+    }
+    ASSERT(maxOut < 0.01f);
+}
+
 int main()
 {
     printf("Vortex DSP Tests\n");
@@ -372,6 +500,19 @@ int main()
     run_filter2_cascade_steeper();
     run_filter2_reset();
 
+    printf("\nResponse morph:\n");
+    run_filter2_morph_endpoints_match_types();
+    run_filter2_morph_sweep_is_continuous();
+    run_filter2_morph_clamps_range();
+
+    printf("\nEnvelope follower:\n");
+    run_follower_attack_and_release_time_constants();
+
+    printf("\nPolyphase resampler:\n");
+    run_resampler_dc_gain_unity();
+    run_resampler_latency_matches_pulse_centroid();
+    run_resampler_attenuates_above_internal_nyquist();
+
     printf("\n%d/%d tests passed\n", tests_passed, tests_run);
     return (tests_passed == tests_run) ? 0 : 1;
 }
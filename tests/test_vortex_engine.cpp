@@ -0,0 +1,377 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Test macros (same pattern as four)
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) \
+    static void test_##name(); \
+    static void run_##name() { \
+        tests_run++; \
+        printf("  %s ... ", #name); \
+        test_##name(); \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+    static void test_##name()
+
+#define ASSERT(cond) \
+    do { if (!(cond)) { \
+        printf("FAIL\n    %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } } while(0)
+
+#define ASSERT_NEAR(a, b, eps) \
+    do { float _a=(a), _b=(b); if (fabsf(_a-_b) > (eps)) { \
+        printf("FAIL\n    %s:%d: %f != %f (eps=%f)\n", \
+               __FILE__, __LINE__, (double)_a, (double)_b, (double)(eps)); \
+        exit(1); \
+    } } while(0)
+
+#include "../src/Vortex/engine.h"
+
+// --- Per-sample engine ---
+
+TEST(engine_lp_passes_dc)
+{
+    vortex::EngineState state;
+    vortex::EngineParams params;
+    params.mode = 1;  // LP 12dB
+    float out = 0.0f;
+    for (int i = 0; i < 4800; i++)
+        out = vortex::engine_process(state, params, 48000.0f, 1.0f);
+    ASSERT_NEAR(out, 1.0f, 0.01f);
+}
+
+TEST(engine_hp24_blocks_dc)
+{
+    vortex::EngineState state;
+    vortex::EngineParams params;
+    params.mode = 5;  // HP 24dB
+    float out = 1.0f;
+    for (int i = 0; i < 4800; i++)
+        out = vortex::engine_process(state, params, 48000.0f, 1.0f);
+    ASSERT_NEAR(out, 0.0f, 0.01f);
+}
+
+TEST(engine_matches_direct_filter)
+{
+    // Engine in BP+ mode must match two hand-configured Filter2 stages
+    vortex::EngineState state;
+    vortex::EngineParams params;
+    params.mode = 7;
+    params.cutoff = 800.0f;
+    params.damping = 0.2f;
+
+    vortex::Filter2 a, b;
+    vortex::filter2_configure(a, 48000.0f, 800.0f, 0.2f, vortex::F2_BP);
+    vortex::filter2_configure(b, 48000.0f, 800.0f, 0.2f, vortex::F2_BP);
+
+    for (int i = 0; i < 1000; i++) {
+        float in = sinf(2.0f * vortex::PI * 440.0f * (float)i / 48000.0f);
+        float ref = vortex::filter2_process(b, vortex::filter2_process(a, in, vortex::F2_BP), vortex::F2_BP);
+        ASSERT_NEAR(vortex::engine_process(state, params, 48000.0f, in), ref, 1e-5f);
+    }
+}
+
+TEST(engine_mode_change_resets_state)
+{
+    vortex::EngineState state;
+    vortex::EngineParams params;
+    params.mode = 1;
+    for (int i = 0; i < 100; i++) vortex::engine_process(state, params, 48000.0f, 1.0f);
+    ASSERT(state.f2a.z0 != 0.0f);
+
+    vortex::engine_update_mode(state, 4);
+    ASSERT_NEAR(state.f2a.z0, 0.0f, 1e-6f);
+    ASSERT_NEAR(state.f2a.z1, 0.0f, 1e-6f);
+}
+
+TEST(engine_morph_change_keeps_state)
+{
+    // Moving the morph position must not reset the filter state
+    vortex::EngineState state;
+    vortex::EngineParams params;
+    params.mode = vortex::MODE_MORPH;
+    for (int i = 0; i < 100; i++) vortex::engine_process(state, params, 48000.0f, 1.0f);
+    float z0 = state.f2a.z0;
+    ASSERT(z0 != 0.0f);
+
+    params.morph = 2.5f;
+    vortex::engine_process(state, params, 48000.0f, 1.0f);
+    ASSERT(state.f2a.z0 != 0.0f);
+    ASSERT(fabsf(state.f2a.z0 - z0) < 0.1f);
+}
+
+TEST(engine_morph_cascade_matches_fixed_mode)
+{
+    // Morph+ at position 0 (LP) matches LP 24dB
+    vortex::EngineState a, b;
+    vortex::EngineParams pa, pb;
+    pa.mode = 2;
+    pb.mode = vortex::MODE_MORPH_CASCADE;
+    pb.morph = 0.0f;
+    for (int i = 0; i < 1000; i++) {
+        float in = sinf(2.0f * vortex::PI * 3000.0f * (float)i / 48000.0f);
+        ASSERT_NEAR(vortex::engine_process(a, pa, 48000.0f, in),
+                    vortex::engine_process(b, pb, 48000.0f, in), 1e-5f);
+    }
+}
+
+// --- Block rendering with parameter events ---
+
+TEST(block_events_land_on_exact_sample)
+{
+    vortex::EngineState stateA, stateB;
+    vortex::EngineParams paramsA, paramsB;
+    paramsA.mode = paramsB.mode = 2;
+
+    float in[512], ref[512], out[512];
+    for (int i = 0; i < 512; i++) {
+        in[i] = sinf(2.0f * vortex::PI * 220.0f * (float)i / 48000.0f);
+        if (i == 128) paramsA.cutoff = 300.0f;
+        if (i == 256) paramsA.drive = 0.5f;
+        if (i == 384) paramsA.damping = 0.1f;
+        ref[i] = vortex::engine_process(stateA, paramsA, 48000.0f, in[i]);
+    }
+
+    wintoid::ParamEventQueue<8> events;
+    events.push(128, vortex::PARAM_CUTOFF, 300.0f);
+    events.push(256, vortex::PARAM_DRIVE, 0.5f);
+    events.push(384, vortex::PARAM_DAMPING, 0.1f);
+    vortex::engine_process_block(stateB, paramsB, 48000.0f, in, out, 512, events);
+
+    for (int i = 0; i < 512; i++)
+        ASSERT_NEAR(out[i], ref[i], 1e-5f);
+    ASSERT(events.peek() == nullptr);
+}
+
+TEST(block_mode_event_clamped)
+{
+    vortex::EngineParams params;
+    vortex::apply_param_event(params, vortex::PARAM_MODE, 40.0f);
+    ASSERT(params.mode == vortex::NUM_MODES - 1);
+    vortex::apply_param_event(params, vortex::PARAM_MODE, -3.0f);
+    ASSERT(params.mode == 0);
+}
+
+// --- Fixed internal rate ---
+
+TEST(fixed_rate_factor_keeps_internal_rate_above_44k)
+{
+    ASSERT(vortex::fixed_rate_factor(44100.0f) == 1);
+    ASSERT(vortex::fixed_rate_factor(48000.0f) == 1);
+    ASSERT(vortex::fixed_rate_factor(88200.0f) == 2);
+    ASSERT(vortex::fixed_rate_factor(96000.0f) == 2);
+    ASSERT(vortex::fixed_rate_factor(176400.0f) == 4);
+    ASSERT(vortex::fixed_rate_factor(192000.0f) == 4);
+    ASSERT(vortex::fixed_rate_factor(768000.0f) == vortex::RESAMPLE_MAX_FACTOR);
+}
+
+TEST(fixed_rate_inactive_matches_host_rate)
+{
+    vortex::EngineState a, b;
+    vortex::FixedRateState fixed;
+    vortex::engine_configure_fixed_rate(a, fixed, 48000.0f, true);
+    ASSERT(!fixed.active());
+    ASSERT(fixed.latency() == 0);
+
+    vortex::EngineParams p;
+    p.mode = 4;
+    p.cutoff = 2000.0f;
+    for (int i = 0; i < 500; i++) {
+        float in = sinf((float)i * 0.05f);
+        float ya = vortex::engine_process_fixed_rate(a, fixed, p, 48000.0f, in);
+        float yb = vortex::engine_process(b, p, 48000.0f, in);
+        ASSERT(ya == yb);
+    }
+}
+
+TEST(fixed_rate_matches_engine_at_internal_rate)
+{
+    // 192kHz host, 48kHz internal: after the resampler latency, every 4th
+    // output should match the engine run directly at 48kHz
+    const float HOST = 192000.0f;
+    vortex::EngineState a, b;
+    vortex::FixedRateState fixed;
+    vortex::engine_configure_fixed_rate(a, fixed, HOST, true);
+    ASSERT(fixed.active());
+    ASSERT_NEAR(fixed.internalRate, 48000.0f, 1e-3f);
+
+    vortex::EngineParams p;
+    p.mode = 1;
+    p.cutoff = 2000.0f;
+    const int N = 9600;
+    const int L = fixed.latency();
+    static float ref[N / 4];
+    for (int m = 0; m < N / 4; m++)
+        ref[m] = vortex::engine_process(b, p, 48000.0f, sinf(2.0f * vortex::PI * 1000.0f * (float)m / 48000.0f));
+
+    float maxErr = 0.0f;
+    for (int i = 0; i < N; i++) {
+        float in = sinf(2.0f * vortex::PI * 1000.0f * (float)i / HOST);
+        float y = vortex::engine_process_fixed_rate(a, fixed, p, HOST, in);
+        if (i > N / 2 && (i - L) % 4 == 0)
+            maxErr = fmaxf(maxErr, fabsf(y - ref[(i - L) / 4]));
+    }
+    ASSERT(maxErr < 0.005f);
+}
+
+TEST(fixed_rate_disable_resets_state)
+{
+    vortex::EngineState state;
+    vortex::FixedRateState fixed;
+    vortex::engine_configure_fixed_rate(state, fixed, 96000.0f, true);
+    ASSERT(fixed.resampler.factor == 2);
+    vortex::EngineParams p;
+    for (int i = 0; i < 100; i++)
+        vortex::engine_process_fixed_rate(state, fixed, p, 96000.0f, 1.0f);
+
+    vortex::engine_configure_fixed_rate(state, fixed, 96000.0f, false);
+    ASSERT(!fixed.active());
+    ASSERT(state.lastMode == -1);
+    ASSERT_NEAR(fixed.internalRate, 96000.0f, 1e-3f);
+}
+
+// --- Envelope follower -> cutoff ---
+
+TEST(follow_settles_on_swept_cutoff)
+{
+    // Constant full-scale square input: envelope -> 1, cutoff -> 500Hz * 2^(0.5*6)
+    vortex::EngineState state;
+    vortex::EngineParams p;
+    p.mode = 1;
+    p.cutoff = 500.0f;
+    p.followAmount = 0.5f;
+    for (int i = 0; i < 48000; i++)
+        vortex::engine_process(state, p, 48000.0f, (i & 1) ? 1.0f : -1.0f);
+
+    vortex::Filter2 ref;
+    vortex::filter2_configure(ref, 48000.0f, vortex::follow_cutoff(500.0f, 1.0f, 0.5f), p.damping, vortex::F2_LP);
+    ASSERT_NEAR(vortex::follow_cutoff(500.0f, 1.0f, 0.5f), 4000.0f, 0.5f);
+    ASSERT_NEAR(state.f2a.b0, ref.b0, 1e-4f);
+    ASSERT_NEAR(state.f2a.b1, ref.b1, 1e-4f);
+    ASSERT_NEAR(state.f2a.b3, ref.b3, 1e-4f);
+}
+
+TEST(follow_interpolates_coefficients)
+{
+    // Sudden burst: coefficients glide on every sample instead of jumping
+    // once per control block
+    vortex::EngineState state;
+    vortex::EngineParams p;
+    p.mode = 1;
+    p.cutoff = 200.0f;
+    p.followAmount = 1.0f;
+    p.followAttack = 0.0005f;
+    p.controlDivision = 32;
+
+    float prevB1 = 0.0f, startB1 = 0.0f;
+    float maxJump = 0.0f;
+    int changes = 0;
+    for (int i = 0; i < 2048; i++) {
+        float in = (i >= 1024) ? ((i & 1) ? 1.0f : -1.0f) : 0.0f;
+        vortex::engine_process(state, p, 48000.0f, in);
+        if (i == 1023)
+            startB1 = state.f2a.b1;
+        if (i > 1024 && i < 1024 + 128 && state.f2a.b1 != prevB1) {
+            changes++;
+            maxJump = fmaxf(maxJump, fabsf(state.f2a.b1 - prevB1));
+        }
+        prevB1 = state.f2a.b1;
+    }
+    float range = fabsf(state.f2a.b1 - startB1);
+    ASSERT(range > 1.0f);
+    ASSERT(changes > 120);
+    ASSERT(maxJump < range / 16.0f);
+}
+
+TEST(follow_block_matches_per_sample)
+{
+    vortex::EngineState a, b;
+    vortex::EngineParams pa, pb;
+    pa.mode = pb.mode = 7;
+    pa.cutoff = pb.cutoff = 800.0f;
+    pa.followAmount = pb.followAmount = -0.4f;
+
+    float in[512], block[512];
+    for (int i = 0; i < 512; i++)
+        in[i] = sinf((float)i * 0.07f) * ((i > 200) ? 1.0f : 0.2f);
+
+    wintoid::ParamEventQueue<16> events;
+    vortex::engine_process_block(b, pb, 48000.0f, in, block, 512, events);
+    for (int i = 0; i < 512; i++)
+        ASSERT_NEAR(block[i], vortex::engine_process(a, pa, 48000.0f, in[i]), 1e-6f);
+}
+
+TEST(follow_every_sample_tracks_cutoff_changes)
+{
+    // controlDivision 1: a cutoff change reaches the coefficients on the
+    // same sample, as without the follower
+    vortex::EngineState state;
+    vortex::EngineParams p;
+    p.mode = 1;
+    p.followAmount = 0.5f;
+    p.controlDivision = 1;
+
+    vortex::Filter2 ref;
+    for (int i = 0; i < 64; i++) {
+        p.cutoff = (i & 1) ? 4000.0f : 300.0f;
+        vortex::engine_process(state, p, 48000.0f, 0.0f);
+        // Silent input: the envelope stays at 0, so the cutoff is unswept
+        vortex::filter2_configure(ref, 48000.0f, p.cutoff, p.damping, vortex::F2_LP);
+        ASSERT_NEAR(state.f2a.b1, ref.b1, 1e-6f);
+    }
+}
+
+TEST(follow_mode_change_applies_immediately)
+{
+    // Switching to a first-order mode mid-block must configure it at once
+    vortex::EngineState state;
+    vortex::EngineParams p;
+    p.mode = 1;
+    p.followAmount = 0.3f;
+    p.controlDivision = 64;
+    for (int i = 0; i < 10; i++)
+        vortex::engine_process(state, p, 48000.0f, 0.5f);
+    p.mode = 0;
+    vortex::engine_process(state, p, 48000.0f, 0.5f);
+    ASSERT(state.f1.b0 > 0.0f);
+    ASSERT(state.lastMode == 0);
+}
+
+int main()
+{
+    printf("Vortex Engine Tests\n");
+    printf("===================\n\n");
+
+    printf("Per-sample engine:\n");
+    run_engine_lp_passes_dc();
+    run_engine_hp24_blocks_dc();
+    run_engine_matches_direct_filter();
+    run_engine_mode_change_resets_state();
+    run_engine_morph_change_keeps_state();
+    run_engine_morph_cascade_matches_fixed_mode();
+
+    printf("\nBlock rendering:\n");
+    run_block_events_land_on_exact_sample();
+    run_block_mode_event_clamped();
+
+    printf("\nFixed internal rate:\n");
+    run_fixed_rate_factor_keeps_internal_rate_above_44k();
+    run_fixed_rate_inactive_matches_host_rate();
+    run_fixed_rate_matches_engine_at_internal_rate();
+    run_fixed_rate_disable_resets_state();
+
+    printf("\nEnvelope follower:\n");
+    run_follow_settles_on_swept_cutoff();
+    run_follow_interpolates_coefficients();
+    run_follow_block_matches_per_sample();
+    run_follow_every_sample_tracks_cutoff_changes();
+    run_follow_mode_change_applies_immediately();
+
+    printf("\n%d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+// Render one Four/Vortex instance from its saved panel values through the
+// headless engines, reporting render cost and writing a WAV.
+// Used by scripts/render_patch.py, which extracts the instances from a
+// saved .vcv patch; can also be run by hand.
+//
+// Usage: render <params.txt> <output.wav> [seconds] [sampleRate]
+//
+// params.txt: the model slug (FourMM or VortexMM) on the first line, then
+// one "<param id> <value>" pair per line (Rack param ids, see panel.h).
+
+#include "render.h"
+#include "wav.h"
+
+#include <stdlib.h>
+
+int main( int argc, char** argv )
+{
+    if ( argc < 3 )
+    {
+        fprintf( stderr, "usage: %s <params.txt> <output.wav> [seconds] [sampleRate]\n", argv[0] );
+        return 1;
+    }
+    float seconds = argc > 3 ? (float)atof( argv[3] ) : 10.f;
+    float sampleRate = argc > 4 ? (float)atof( argv[4] ) : 48000.f;
+    if ( seconds <= 0.f || sampleRate <= 0.f )
+    {
+        fprintf( stderr, "seconds and sampleRate must be positive\n" );
+        return 1;
+    }
+
+    std::string model;
+    std::vector<PanelValue> saved;
+    if ( !read_params( argv[1], model, saved ) )
+    {
+        fprintf( stderr, "%s: not a readable params file\n", argv[1] );
+        return 1;
+    }
+    bool isFour = model == "FourMM";
+    if ( !isFour && model != "VortexMM" )
+    {
+        fprintf( stderr, "%s: unsupported model '%s'\n", argv[1], model.c_str() );
+        return 1;
+    }
+
+    float fourValues[four::PANEL_PARAMS_LEN];
+    float vortexValues[vortex::PANEL_PARAMS_LEN];
+    four::panel_defaults( fourValues );
+    vortex::panel_defaults( vortexValues );
+    apply_params( saved, fourValues, four::PANEL_PARAMS_LEN );
+    apply_params( saved, vortexValues, vortex::PANEL_PARAMS_LEN );
+
+    int frames = (int)( seconds * sampleRate );
+    std::vector<float> out( frames );
+    Clock::duration elapsed;
+    if ( isFour )
+        render_four( fourValues, sampleRate, out.data(), frames, elapsed );
+    else
+    {
+        std::vector<float> in( frames );
+        render_vortex_input( sampleRate, in.data(), frames );
+        render_vortex( vortexValues, sampleRate, in.data(), out.data(), frames, elapsed );
+    }
+
+    double renderSeconds = std::chrono::duration<double>( elapsed ).count();
+    printf( "%s: %d frames (%.2f s at %.0f Hz)\n", model.c_str(), frames, seconds, sampleRate );
+    printf( "render: %.1f ns/sample, %.1fx realtime\n",
+            renderSeconds * 1e9 / frames, renderSeconds > 0.0 ? seconds / renderSeconds : 0.0 );
+
+    if ( !wintoid::write_wav( argv[2], out.data(), (uint32_t)frames, (uint32_t)sampleRate ) )
+    {
+        fprintf( stderr, "%s: write failed\n", argv[2] );
+        return 1;
+    }
+    return 0;
+}
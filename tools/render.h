@@ -0,0 +1,126 @@
+#ifndef WINTOID_RENDER_H
+#define WINTOID_RENDER_H
+
+// Generic offline renderers for one Four/Vortex instance from its saved
+// panel values, shared by tools/render and the kernels emitted by
+// scripts/generate_kernel.py (as their reference path).
+// Four plays C4 with no CV; Vortex filters a 110 Hz saw at 5V.
+
+#include "../src/Four/panel.h"
+#include "../src/Vortex/panel.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+static const int BLOCK = four::MOD_CONTROL_DIVISION;
+typedef std::chrono::steady_clock Clock;
+
+// Vortex input: 110 Hz saw, normalized (5V = 1.0)
+inline void render_vortex_input( float sampleRate, float* in, int frames )
+{
+    float phase = 0.f;
+    for ( int i = 0; i < frames; i++ )
+    {
+        in[i] = 2.f * phase - 1.f;
+        phase += 110.f / sampleRate;
+        phase -= floorf( phase );
+    }
+}
+
+struct PanelValue
+{
+    int id;
+    float value;
+};
+
+// Reads the model slug and the saved param values
+inline bool read_params( const char* path, std::string& model, std::vector<PanelValue>& values )
+{
+    FILE* f = fopen( path, "r" );
+    if ( !f )
+        return false;
+
+    char slug[64];
+    if ( fscanf( f, "%63s", slug ) != 1 )
+    {
+        fclose( f );
+        return false;
+    }
+    model = slug;
+
+    PanelValue v;
+    while ( fscanf( f, "%d %f", &v.id, &v.value ) == 2 )
+        values.push_back( v );
+    fclose( f );
+    return true;
+}
+
+// Overlay saved values on the defaults. Unknown ids are ignored.
+inline void apply_params( const std::vector<PanelValue>& saved, float* values, int count )
+{
+    for ( size_t i = 0; i < saved.size(); i++ )
+        if ( saved[i].id >= 0 && saved[i].id < count )
+            values[saved[i].id] = saved[i].value;
+}
+
+// Four through engine_process_block with control-rate built-in modulation.
+// elapsed: render time, excluding setup
+inline void render_four( const float* values, float sampleRate, float* out, int frames, Clock::duration& elapsed )
+{
+    four::EngineState state;
+    four::engine_set_sample_rate( state, sampleRate );
+    four::EngineParams params = four::panel_engine_params( values );
+    four::ModParams modParams;
+    four::ModState modState;
+    four::panel_mod_params( values, modParams );
+    bool modulated = four::mod_params_active( modParams );
+
+    static wintoid::ParamEventQueue<16> events;
+    float dt = BLOCK / sampleRate;
+
+    Clock::time_point t0 = Clock::now();
+    for ( int pos = 0; pos < frames; pos += BLOCK )
+    {
+        // Same control-rate modulation as the module (no gate, so envelopes stay idle)
+        if ( modulated )
+        {
+            float lfo[4], env[4];
+            float offset[four::NUM_MOD_TARGETS][4];
+            four::mod_sources_tick( modState, modParams, dt, false, lfo, env );
+            four::mod_matrix( modParams, lfo, env, offset );
+            four::engine_set_modulation( state, offset, BLOCK );
+        }
+        int n = std::min( BLOCK, frames - pos );
+        four::engine_process_block( state, params, 1.f / sampleRate, nullptr, out + pos, n, events );
+    }
+    elapsed = Clock::now() - t0;
+}
+
+// Vortex through engine_process_block, or per sample at the fixed internal rate
+inline void render_vortex( const float* values, float sampleRate, const float* in, float* out, int frames, Clock::duration& elapsed )
+{
+    vortex::EngineState state;
+    vortex::FixedRateState fixed;
+    vortex::EngineParams params = vortex::panel_engine_params( values );
+    vortex::engine_configure_fixed_rate( state, fixed, sampleRate, vortex::panel_fixed_rate( values ) );
+
+    static wintoid::ParamEventQueue<16> events;
+
+    Clock::time_point t0 = Clock::now();
+    if ( fixed.active() )
+    {
+        for ( int i = 0; i < frames; i++ )
+            out[i] = vortex::engine_process_fixed_rate( state, fixed, params, sampleRate, in[i] );
+    }
+    else
+    {
+        for ( int pos = 0; pos < frames; pos += BLOCK )
+            vortex::engine_process_block( state, params, sampleRate, in + pos, out + pos,
+                                          std::min( BLOCK, frames - pos ), events );
+    }
+    elapsed = Clock::now() - t0;
+}
+
+#endif // WINTOID_RENDER_H
@@ -0,0 +1,113 @@
+// Replay a Four/Vortex input capture (see src/capture.h) through the
+// headless engines, reporting render cost and optionally writing a WAV.
+//
+// Usage: replay <capture.wcap> [output.wav]
+
+#include "../src/capture.h"
+#include "../src/Four/engine.h"
+#include "../src/Vortex/engine.h"
+#include "wav.h"
+
+#include <chrono>
+#include <string.h>
+#include <vector>
+
+static const int BLOCK = 64;
+typedef wintoid::ParamEventQueue<4096> EventQueue;
+typedef std::chrono::steady_clock Clock;
+
+// Read up to BLOCK frames, turning parameter changes into events and the
+// audio-rate channel into a sample buffer. Returns the number of frames read.
+static int read_block( wintoid::CaptureReader& reader, std::vector<float>& current, int paramCount,
+                       float* audio, EventQueue& events )
+{
+    int n = 0;
+    const float* frame;
+    while ( n < BLOCK && ( frame = reader.next() ) != nullptr )
+    {
+        for ( int id = 0; id < paramCount; id++ )
+        {
+            if ( frame[id] != current[id] )
+            {
+                events.push( n, id, frame[id] );
+                current[id] = frame[id];
+            }
+        }
+        audio[n] = frame[paramCount];
+        n++;
+    }
+    return n;
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <capture.wcap> [output.wav]\n", argv[0] );
+        return 1;
+    }
+
+    wintoid::CaptureReader reader;
+    if ( !reader.open( argv[1] ) )
+    {
+        fprintf( stderr, "%s: not a readable capture file, or one from an older version\n", argv[1] );
+        return 1;
+    }
+
+    bool isFour = memcmp( reader.header.tag, "FOUR", 4 ) == 0;
+    bool isVortex = memcmp( reader.header.tag, "VRTX", 4 ) == 0;
+    int expected = isFour ? four::CAPTURE_CHANNELS : vortex::CAPTURE_CHANNELS;
+    if ( ( !isFour && !isVortex ) || (int)reader.header.channels != expected )
+    {
+        fprintf( stderr, "%s: unsupported module tag or channel layout\n", argv[1] );
+        return 1;
+    }
+
+    float sampleRate = reader.header.sampleRate;
+    int paramCount = expected - 1;
+
+    four::EngineState fourState;
+    four::engine_set_sample_rate( fourState, sampleRate );
+    four::EngineParams fourParams;
+    vortex::EngineState vortexState;
+    vortex::EngineParams vortexParams;
+
+    // Start from the engine defaults so the first frame's events set everything
+    std::vector<float> current( paramCount );
+    for ( int id = 0; id < paramCount; id++ )
+        current[id] = isFour ? four::engine_param_value( fourParams, id )
+                             : vortex::engine_param_value( vortexParams, id );
+
+    static EventQueue events;
+    float audio[BLOCK];
+    float out[BLOCK];
+    std::vector<float> rendered;
+    Clock::duration elapsed = Clock::duration::zero();
+
+    int n;
+    while ( ( n = read_block( reader, current, paramCount, audio, events ) ) > 0 )
+    {
+        Clock::time_point t0 = Clock::now();
+        if ( isFour )
+            four::engine_process_block( fourState, fourParams, 1.f / sampleRate, audio, out, n, events );
+        else
+            vortex::engine_process_block( vortexState, vortexParams, sampleRate, audio, out, n, events );
+        elapsed += Clock::now() - t0;
+
+        rendered.insert( rendered.end(), out, out + n );
+    }
+
+    double seconds = std::chrono::duration<double>( elapsed ).count();
+    double audioSeconds = rendered.size() / (double)sampleRate;
+    printf( "%.4s: %zu frames (%.2f s at %.0f Hz)\n", reader.header.tag, rendered.size(), audioSeconds, sampleRate );
+    if ( !rendered.empty() )
+        printf( "render: %.1f ns/sample, %.1fx realtime\n",
+                seconds * 1e9 / rendered.size(), seconds > 0.0 ? audioSeconds / seconds : 0.0 );
+
+    if ( argc > 2 && !wintoid::write_wav( argv[2], rendered.data(), (uint32_t)rendered.size(), (uint32_t)sampleRate ) )
+    {
+        fprintf( stderr, "%s: write failed\n", argv[2] );
+        return 1;
+    }
+    return 0;
+}
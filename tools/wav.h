@@ -0,0 +1,46 @@
+#ifndef WINTOID_WAV_H
+#define WINTOID_WAV_H
+
+// Minimal mono 32-bit float WAV writer for the offline tools.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+namespace wintoid {
+
+inline bool write_wav( const std::string& path, const float* samples, uint32_t frames, uint32_t sampleRate )
+{
+    FILE* f = fopen( path.c_str(), "wb" );
+    if ( !f )
+        return false;
+
+    uint32_t dataBytes = frames * 4;
+    uint32_t riffBytes = 36 + dataBytes;
+    uint32_t fmtBytes = 16;
+    uint16_t format = 3;            // IEEE float
+    uint16_t channels = 1;
+    uint32_t byteRate = sampleRate * 4;
+    uint16_t blockAlign = 4;
+    uint16_t bits = 32;
+
+    fwrite( "RIFF", 1, 4, f );
+    fwrite( &riffBytes, 4, 1, f );
+    fwrite( "WAVEfmt ", 1, 8, f );
+    fwrite( &fmtBytes, 4, 1, f );
+    fwrite( &format, 2, 1, f );
+    fwrite( &channels, 2, 1, f );
+    fwrite( &sampleRate, 4, 1, f );
+    fwrite( &byteRate, 4, 1, f );
+    fwrite( &blockAlign, 2, 1, f );
+    fwrite( &bits, 2, 1, f );
+    fwrite( "data", 1, 4, f );
+    fwrite( &dataBytes, 4, 1, f );
+    fwrite( samples, 4, frames, f );
+
+    return fclose( f ) == 0;
+}
+
+} // namespace wintoid
+
+#endif // WINTOID_WAV_H